@@ -0,0 +1,923 @@
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include "anya.hpp"
+#include "batch.hpp"
+#include "compositor.hpp"
+#include "diskcache.hpp"
+#include "image.hpp"
+#include "scene.hpp"
+#include "transition.hpp"
+#include "uinterface.hpp"
+#include "worldclock.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/** Structure
+ *
+ * anya_bench -> micro-benchmarks of the per-frame helpers, run headless (SDL dummy video driver) on a software
+ *               renderer drawing into a surface
+ * Case -> one helper at one input size, timed in 5 rounds after a warm-up, the median & fastest round are kept
+ * Output -> JSON (name, size, iterations, ns per op, renderer calls per op) on stdout or in --out,
+ *           keep one file per commit and compare them with any JSON diff
+ * Verify -> --verify draws one frame through the compositor with every kernel & through the SDL renderer, the
+ *           kernels have to match each other exactly & SDL within a rounding tolerance (exit code 1 if not), the
+ *           premultiplied layers the straight alpha ones within the same tolerance; the same goes for buttons
+ *           drawn by a Batch into a compositor (fills, outlines & stretched icons); the gif is loaded & released
+ *           twice through a scene manifest & has to give every texture & layer byte back
+ *
+ * usage: anya_bench [--filter <text>] [--out <file>] [--min-time <ms>] [--assets <dir>] [--verify]
+ */
+
+using namespace Application;
+using namespace Application::Helper;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Result final {
+        std::basic_string<char> name;
+        int64_t size {0};
+        uint64_t iterations {0};
+        double nsPerOp {0.0};
+        double minNsPerOp {0.0};
+        // renderer calls per op (batching cases only)
+        double calls {-1.0};
+    };
+
+    struct Options final {
+        std::basic_string<char> filter {};
+        std::basic_string<char> outFile {};
+        std::basic_string<char> assets {ANYA_ASSETS_DIR};
+        double minTime {200.0};
+        bool verify {false};
+    };
+
+    class Runner final {
+    public:
+        explicit Runner(const Options &options) : options(options) {}
+
+        bool wants(std::string_view name) const {
+            return options.filter.empty() || name.find(options.filter) != std::string_view::npos;
+        }
+
+        // fn(uint64_t i) runs one op, i counts up across the whole case
+        template <class F> Result &run(std::string_view name, int64_t size, F &&fn) {
+            constexpr int rounds = 5;
+            uint64_t i = 0;
+
+            // grow the round until it takes a fifth of the minimum time
+            uint64_t iterations = 1;
+            for (;;) {
+                const Clock::time_point start = Clock::now();
+                for (uint64_t n = 0; n < iterations; ++n)
+                    fn(i++);
+                const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                if (elapsed >= options.minTime / rounds || iterations >= (1ull << 30))
+                    break;
+                iterations *= 2;
+            }
+
+            std::vector<double> perOp;
+            for (int round = 0; round < rounds; ++round) {
+                const Clock::time_point start = Clock::now();
+                for (uint64_t n = 0; n < iterations; ++n)
+                    fn(i++);
+                const double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                perOp.push_back(elapsed / static_cast<double>(iterations));
+            }
+            std::sort(perOp.begin(), perOp.end());
+
+            Result &result = results.emplace_back();
+            result.name = name;
+            result.size = size;
+            result.iterations = iterations * rounds;
+            result.nsPerOp = perOp[rounds / 2];
+            result.minNsPerOp = perOp.front();
+
+            std::cerr << std::format("{:<32} {:>6} {:>14.1f} ns/op\n", name, size, result.nsPerOp);
+            return result;
+        }
+
+        int write() const {
+            std::basic_string<char> json = "{\n  \"results\": [\n";
+            for (size_t i = 0; i < results.size(); ++i) {
+                const Result &result = results[i];
+                json += std::format("    {{\"name\": \"{}\", \"size\": {}, \"iterations\": {}, \"ns_per_op\": {:.2f}, "
+                                    "\"min_ns_per_op\": {:.2f}",
+                                    result.name, result.size, result.iterations, result.nsPerOp, result.minNsPerOp);
+                if (result.calls >= 0.0)
+                    json += std::format(", \"calls_per_op\": {:.2f}", result.calls);
+                json += (i + 1 < results.size()) ? "},\n" : "}\n";
+            }
+            json += "  ]\n}\n";
+
+            if (options.outFile.empty()) {
+                std::cout << json;
+                return 0;
+            }
+
+            std::ofstream out(options.outFile, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "Failed to write " << options.outFile << '\n';
+                return -1;
+            }
+            out << json;
+
+            return 0;
+        }
+
+    private:
+        const Options &options;
+        std::vector<Result> results {};
+    };
+
+    // keeps the optimizer from dropping a result
+    void keep(uint64_t value) {
+        static volatile uint64_t sink;
+        sink = value;
+    }
+
+    void benchText(Runner &runner, Image &image, SDL_Renderer *ren, const Options &options) {
+        const std::basic_string<char> font = options.assets + "Onest.ttf";
+
+        for (const int length : {8, 32, 128}) {
+            const std::basic_string<char> base(static_cast<size_t>(length), 'a');
+
+            if (runner.wants("createText/hit")) {
+                ImageHandle text {};
+                runner.run("createText/hit", length, [&](uint64_t) {
+                    text = image.createText({base, font, {{0}, {0}, {255, 255, 255}}, 16}, ren, text);
+                });
+                image.remove(text);
+            }
+
+            if (runner.wants("createText/miss")) {
+                ImageHandle text {};
+                runner.run("createText/miss", length, [&](uint64_t i) {
+                    std::basic_string<char> msg = base;
+                    msg[0] = static_cast<char>('a' + i % 26);
+                    msg[msg.size() / 2] = static_cast<char>('a' + i / 26 % 26);
+                    text = image.createText({msg, font, {{0}, {0}, {255, 255, 255}}, 16}, ren, text);
+                });
+                image.remove(text);
+            }
+
+            if (runner.wants("createTextA/hit")) {
+                ImageHandle text {};
+                runner.run("createTextA/hit", length, [&](uint64_t) {
+                    text = image.createTextA({base, font, {{0}, {0}, {255, 255, 255}}, 28}, ren, text);
+                });
+                image.remove(text);
+            }
+
+            if (runner.wants("createTextA/miss")) {
+                ImageHandle text {};
+                runner.run("createTextA/miss", length, [&](uint64_t i) {
+                    std::basic_string<char> msg = base;
+                    msg[0] = static_cast<char>('a' + i % 26);
+                    msg[msg.size() / 2] = static_cast<char>('a' + i / 26 % 26);
+                    text = image.createTextA({msg, font, {{0}, {0}, {255, 255, 255}}, 28}, ren, text);
+                });
+                image.remove(text);
+            }
+        }
+    }
+
+    void benchImage(Runner &runner, Image &image, SDL_Renderer *ren, const Options &options) {
+        if (runner.wants("createImage/hit")) {
+            const std::basic_string<char> path = options.assets + "25231.png";
+            // the first load decodes, every later one is a registry lookup
+            image.createImage(path, ren);
+            runner.run("createImage/hit", 1, [&](uint64_t) { keep(image.createImage(path, ren).id); });
+        }
+
+        // a disk cache hit (size & mtime checked, no hash) against decoding the same file
+        const std::basic_string<char> icon = options.assets + "calendar.png";
+        if (runner.wants("IMG_Load")) {
+            runner.run("IMG_Load", 1, [&](uint64_t) {
+                SDL_Surface *surf = IMG_Load(icon.c_str());
+                keep(static_cast<uint64_t>(surf != nullptr));
+                SDL_FreeSurface(surf);
+            });
+        }
+
+        if (runner.wants("DiskCache::load")) {
+            DiskCache cache;
+            SDL_Surface *decoded = IMG_Load(icon.c_str());
+            if (cache.isEnabled() && decoded != nullptr && cache.store(icon, decoded) == 0) {
+                runner.run("DiskCache::load", 1, [&](uint64_t) {
+                    SDL_Surface *surf = cache.load(icon);
+                    keep(static_cast<uint64_t>(surf != nullptr));
+                    SDL_FreeSurface(surf);
+                });
+            }
+            SDL_FreeSurface(decoded);
+        }
+
+        if (!runner.wants("createPack"))
+            return;
+
+        // packs of the first n gif frames, copied to a temporary directory
+        std::vector<std::filesystem::path> extracted;
+        for (const auto &entry : std::filesystem::directory_iterator(options.assets + "gif-extract/"))
+            extracted.push_back(entry.path());
+        std::sort(extracted.begin(), extracted.end());
+
+        const std::filesystem::path packDir = std::filesystem::temp_directory_path() / "anya-bench-pack";
+        for (const size_t frames : {8, 32, 68}) {
+            if (frames > extracted.size())
+                break;
+
+            std::error_code error;
+            std::filesystem::remove_all(packDir, error);
+            std::filesystem::create_directories(packDir, error);
+            for (size_t i = 0; i < frames; ++i)
+                std::filesystem::copy_file(extracted[i], packDir / extracted[i].filename(), error);
+
+            const std::basic_string<char> dir = packDir.string() + "/";
+            runner.run("createPack", static_cast<int64_t>(frames), [&](uint64_t) {
+                ImageHandle canvas = image.createPack("bench", dir, ren);
+                image.remove(canvas);
+            });
+        }
+
+        std::error_code error;
+        std::filesystem::remove_all(packDir, error);
+    }
+
+    void benchAnimation(Runner &runner, SDL_Renderer *ren) {
+        for (const int frames : {8, 68, 512}) {
+            Animation animation;
+            animation.addAnimation(frames, 0, 0, 148, 89);
+
+            if (runner.wants("Animation::update"))
+                runner.run("Animation::update", frames, [&](uint64_t) { animation.update(37.0f, 16.0); });
+
+            if (runner.wants("Animation::draw")) {
+                // one row of frames, like a gif atlas (clamped to what the renderer allows)
+                SDL_Texture *atlas = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                                       std::min(frames * 148, 16384), 89);
+                runner.run("Animation::draw", frames, [&](uint64_t) {
+                    animation.update(0.0f, 1.0);
+                    animation.draw(atlas, ren, 0, 0);
+                });
+                SDL_DestroyTexture(atlas);
+            }
+        }
+    }
+
+    void benchInterface(Runner &runner, Image &image, SDL_Renderer *ren) {
+        for (const int count : {16, 256, 4096}) {
+            // buttons spread over an area that grows with the count, about 4 buttons under any point
+            const int side = std::max(148, static_cast<int>(std::sqrt(count * 24.0 * 12.0 / 4.0)));
+            std::mt19937 rng(1234);
+            std::uniform_int_distribution<int> coord(0, side - 24);
+
+            UInterface ui(image);
+            for (int i = 0; i < count; ++i)
+                ui.createButton("", 0, coord(rng), coord(rng), 24, 12);
+            ui.setHitArea(side, side);
+            ui.setActiveLayer(0);
+
+            std::vector<SDL_Point> points(1024);
+            for (auto &point : points)
+                point = {coord(rng), coord(rng)};
+
+            if (runner.wants("UInterface::update")) {
+                SDL_Event ev {};
+                ev.type = SDL_MOUSEMOTION;
+                runner.run("UInterface::update", count, [&](uint64_t i) {
+                    const SDL_Point &point = points[i % points.size()];
+                    ev.motion.x = point.x;
+                    ev.motion.y = point.y;
+                    ui.update(&ev, 1.0);
+                });
+            }
+
+            if (runner.wants("UInterface::getButtonsAt")) {
+                runner.run("UInterface::getButtonsAt", count,
+                           [&](uint64_t i) { keep(ui.getButtonsAt(points[i % points.size()]).size()); });
+            }
+
+            // the same frame composited on the cpu (as the scenes draw it), including the upload
+            if (runner.wants("UInterface::draw/composited") && count <= 256) {
+                Compositor compositor;
+                compositor.create(ren, 148, 89);
+                ui.getBatch().setDrawTarget(&compositor);
+                runner.run("UInterface::draw/composited", count, [&](uint64_t) {
+                    compositor.clear({0, 0, 0, 255});
+                    for (ButtonID button = 0; button < ui.getButtonCount(); ++button)
+                        ui.draw(button, ren);
+                    ui.flush(ren);
+                    compositor.present(ren);
+                });
+                ui.getBatch().setDrawTarget(nullptr);
+            }
+
+            // a frame of buttons, batched into SDL_RenderGeometry calls or drawn call by call
+            for (const bool immediate : {false, true}) {
+                const char *name = immediate ? "UInterface::draw/immediate" : "UInterface::draw/batched";
+                if (!runner.wants(name) || count > 256)
+                    continue;
+
+                const auto frame = [&](uint64_t) {
+                    for (ButtonID button = 0; button < ui.getButtonCount(); ++button)
+                        ui.draw(button, ren);
+                    ui.flush(ren);
+                };
+
+                ui.getBatch().setImmediate(immediate);
+                Result &result = runner.run(name, count, frame);
+
+                // renderer calls of one more frame
+                ui.getBatch().resetCallCount();
+                frame(0);
+                result.calls = static_cast<double>(ui.getBatch().getCallCount());
+            }
+        }
+    }
+
+    void benchWorldClock(Runner &runner, Image &image, SDL_Renderer *ren, const Options &options) {
+        constexpr std::array<std::string_view, 8> zoneNames {"Europe/London",  "America/New_York", "Asia/Tokyo",
+                                                             "Asia/Kolkata",   "Australia/Sydney", "America/Sao_Paulo",
+                                                             "Africa/Nairobi", "Pacific/Chatham"};
+        const auto now = std::chrono::system_clock::now();
+
+        for (const int count : {1, 4, 16, 64}) {
+            WorldClock clocks(image);
+            if (clocks.create(ren, options.assets + "Onest.ttf", 9) != 0)
+                return;
+            for (int i = 0; i < count; ++i)
+                clocks.addClock(zoneNames[static_cast<size_t>(i) % zoneNames.size()]);
+            clocks.update(now);
+
+            // a frame between minute boundaries, the glyph quads of every clock in one batch
+            if (runner.wants("WorldClock::draw")) {
+                Result &result = runner.run("WorldClock::draw", count, [&](uint64_t) {
+                    clocks.update(now);
+                    clocks.draw(ren, 0, 0);
+                });
+
+                clocks.getBatch().resetCallCount();
+                clocks.draw(ren, 0, 0);
+                result.calls = static_cast<double>(clocks.getBatch().getCallCount());
+            }
+
+            // a frame on a minute boundary, every clock is laid out again
+            if (runner.wants("WorldClock::tick")) {
+                runner.run("WorldClock::tick", count, [&](uint64_t i) {
+                    clocks.update(now + std::chrono::minutes(i % 1440));
+                    clocks.draw(ren, 0, 0);
+                });
+            }
+        }
+    }
+
+    // the layers of a main scene frame: an opaque background, text (mostly transparent with soft edges) & an icon
+    struct FrameLayers final {
+        Layer background {};
+        Layer text {};
+        Layer icon {};
+    };
+
+    FrameLayers makeLayers() {
+        std::mt19937 rng(42);
+        FrameLayers layers;
+        layers.background = {std::vector<uint32_t>(148 * 89), 148, 89};
+        for (uint32_t &pixel : layers.background.pixels)
+            pixel = 0xFF000000u | (rng() & 0xFFFFFF);
+
+        // glyph-like stripes: transparent gaps, opaque strokes & partial alpha at their edges
+        layers.text = {std::vector<uint32_t>(120 * 36), 120, 36};
+        for (size_t i = 0; i < layers.text.pixels.size(); ++i) {
+            const int phase = static_cast<int>(i % 120) % 9;
+            const uint32_t alpha = (phase < 4) ? 0 : (phase == 4 || phase == 8) ? (rng() & 0xFF) : 0xFF;
+            layers.text.pixels[i] = (alpha << 24) | 0xFFFFFF;
+        }
+
+        layers.icon = {std::vector<uint32_t>(16 * 16), 16, 16};
+        for (uint32_t &pixel : layers.icon.pixels)
+            pixel = rng();
+
+        return layers;
+    }
+
+    // the layers as textures, to draw the same frame through the renderer
+    struct FrameTextures final {
+        SDL_Texture *background {nullptr};
+        SDL_Texture *text {nullptr};
+        SDL_Texture *icon {nullptr};
+    };
+
+    SDL_Texture *toTexture(const Layer &layer, SDL_Renderer *ren, SDL_BlendMode mode) {
+        SDL_Texture *texture =
+            SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, layer.w, layer.h);
+        SDL_UpdateTexture(texture, nullptr, layer.pixels.data(), layer.w * 4);
+        SDL_SetTextureBlendMode(texture, mode);
+
+        return texture;
+    }
+
+    constexpr SDL_Color textMod {240, 209, 189, 200};
+    constexpr SDL_Color iconMod {255, 255, 255, 255};
+    constexpr SDL_Color menuFill {26, 17, 16, 160};
+    constexpr SDL_Color buttonFill {255, 255, 255, 90};
+    constexpr SDL_Rect textClip {0, 0, 120, 30};
+
+    void drawFrame(Compositor &compositor, const FrameLayers &layers) {
+        compositor.copy(layers.background, 0, 0);
+        compositor.fillRect({4, 4, 140, 40}, menuFill);
+        compositor.blend(layers.text, &textClip, 14, 56, textMod);
+        compositor.fillRect({120, 6, 22, 12}, buttonFill);
+        compositor.blend(layers.icon, nullptr, 123, 4, iconMod);
+    }
+
+    void drawFrame(SDL_Renderer *ren, const FrameTextures &textures) {
+        SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+        SDL_RenderCopy(ren, textures.background, nullptr, nullptr);
+
+        const SDL_Rect menu {4, 4, 140, 40};
+        SDL_SetRenderDrawColor(ren, menuFill.r, menuFill.g, menuFill.b, menuFill.a);
+        SDL_RenderFillRect(ren, &menu);
+
+        const SDL_Rect textDst {14, 56, textClip.w, textClip.h};
+        SDL_SetTextureColorMod(textures.text, textMod.r, textMod.g, textMod.b);
+        SDL_SetTextureAlphaMod(textures.text, textMod.a);
+        SDL_RenderCopy(ren, textures.text, &textClip, &textDst);
+
+        const SDL_Rect button {120, 6, 22, 12};
+        SDL_SetRenderDrawColor(ren, buttonFill.r, buttonFill.g, buttonFill.b, buttonFill.a);
+        SDL_RenderFillRect(ren, &button);
+
+        const SDL_Rect iconDst {123, 4, 16, 16};
+        SDL_RenderCopy(ren, textures.icon, nullptr, &iconDst);
+    }
+
+    void benchCompositor(Runner &runner, SDL_Renderer *ren) {
+        const FrameLayers layers = makeLayers();
+        const FrameTextures textures {toTexture(layers.background, ren, SDL_BLENDMODE_NONE),
+                                      toTexture(layers.text, ren, SDL_BLENDMODE_BLEND),
+                                      toTexture(layers.icon, ren, SDL_BLENDMODE_BLEND)};
+
+        // a whole frame, the SDL renderer against the compositor (including its upload)
+        if (runner.wants("Frame/sdl"))
+            runner.run("Frame/sdl", 148 * 89, [&](uint64_t) { drawFrame(ren, textures); });
+
+        // the background of a settings menu every frame, a flat fill against the cached blurred backdrop
+        if (runner.wants("Menu/fill")) {
+            const SDL_Rect view {0, 0, 148, 89};
+            runner.run("Menu/fill", 148 * 89, [&](uint64_t) {
+                SDL_SetRenderDrawColor(ren, menuFill.r, menuFill.g, menuFill.b, 255);
+                SDL_RenderFillRect(ren, &view);
+            });
+        }
+        if (runner.wants("Menu/backdrop")) {
+            Compositor backdrop;
+            backdrop.create(ren, 148, 89);
+            drawFrame(backdrop, layers);
+            runner.run("Menu/backdrop", 148 * 89, [&](uint64_t) { backdrop.present(ren); });
+        }
+
+        // --draw cpu: the blurred & dimmed pixels are copied into the scene frame, which is presented anyway
+        if (runner.wants("Menu/backdrop/composited")) {
+            Compositor backdrop;
+            backdrop.create(ren, 148, 89);
+            drawFrame(backdrop, layers);
+            const Layer dimmed {std::vector<uint32_t>(backdrop.getPixels(), backdrop.getPixels() + 148 * 89), 148, 89,
+                                true};
+            Compositor frame;
+            frame.create(ren, 148, 89);
+            runner.run("Menu/backdrop/composited", 148 * 89, [&](uint64_t) {
+                frame.copy(dimmed, 0, 0);
+                frame.present(ren);
+            });
+        }
+
+        for (const Kernel kernel : {Kernel::Scalar, Kernel::SSE2, Kernel::AVX2}) {
+            if (!Compositor::isSupported(kernel))
+                continue;
+
+            const std::basic_string<char> frameName = std::format("Frame/{}", Compositor::getKernelName(kernel));
+            if (runner.wants(frameName)) {
+                Compositor compositor;
+                compositor.create(ren, 148, 89);
+                compositor.setKernel(kernel);
+                runner.run(frameName, 148 * 89, [&](uint64_t) {
+                    drawFrame(compositor, layers);
+                    compositor.present(ren);
+                });
+            }
+
+            // throughput of the row kernels on square frames
+            for (const int side : {64, 256, 1024}) {
+                Compositor compositor;
+                compositor.create(ren, side, side);
+                compositor.setKernel(kernel);
+
+                Layer layer {std::vector<uint32_t>(static_cast<size_t>(side) * side), side, side};
+                for (size_t i = 0; i < layer.pixels.size(); ++i)
+                    layer.pixels[i] = layers.icon.pixels[i % layers.icon.pixels.size()];
+
+                const std::basic_string<char> blendName =
+                    std::format("Compositor::blend/{}", Compositor::getKernelName(kernel));
+                if (runner.wants(blendName)) {
+                    runner.run(blendName, side * side,
+                               [&](uint64_t) { compositor.blend(layer, nullptr, 0, 0, textMod); });
+                }
+
+                // the same layer premultiplied (--alpha premultiplied), one product less per channel
+                const std::basic_string<char> premultipliedName =
+                    std::format("Compositor::blend/premultiplied/{}", Compositor::getKernelName(kernel));
+                if (runner.wants(premultipliedName)) {
+                    Layer premultiplied = layer;
+                    premultiplyAlpha(premultiplied.pixels.data(), premultiplied.pixels.size(), kernel);
+                    premultiplied.premultiplied = true;
+                    const SDL_Color mod = premultiplyMod(textMod);
+                    runner.run(premultipliedName, side * side,
+                               [&](uint64_t) { compositor.blend(premultiplied, nullptr, 0, 0, mod); });
+                }
+
+                const std::basic_string<char> premultiplyName =
+                    std::format("premultiplyAlpha/{}", Compositor::getKernelName(kernel));
+                if (runner.wants(premultiplyName)) {
+                    // premultiplying twice is no cheaper than once, the same buffer is reused
+                    runner.run(premultiplyName, side * side,
+                               [&](uint64_t) { premultiplyAlpha(layer.pixels.data(), layer.pixels.size(), kernel); });
+                }
+
+                const std::basic_string<char> keyName =
+                    std::format("colorKeyToAlpha/{}", Compositor::getKernelName(kernel));
+                if (runner.wants(keyName)) {
+                    runner.run(keyName, side * side, [&](uint64_t) {
+                        colorKeyToAlpha(layer.pixels.data(), layer.pixels.size(), {26, 17, 16, 255}, 8, kernel);
+                    });
+                }
+
+                const std::basic_string<char> blurName = std::format("boxBlur/{}", Compositor::getKernelName(kernel));
+                if (runner.wants(blurName)) {
+                    // the settings backdrop, done once when the menu opens
+                    runner.run(blurName, side * side,
+                               [&](uint64_t) { boxBlur(layer.pixels.data(), side, side, 4, 3, kernel); });
+                }
+
+                const std::basic_string<char> fillName =
+                    std::format("Compositor::fillRect/{}", Compositor::getKernelName(kernel));
+                if (runner.wants(fillName)) {
+                    runner.run(fillName, side * side,
+                               [&](uint64_t) { compositor.fillRect({0, 0, side, side}, menuFill); });
+                }
+            }
+        }
+
+        SDL_DestroyTexture(textures.background);
+        SDL_DestroyTexture(textures.text);
+        SDL_DestroyTexture(textures.icon);
+    }
+
+    void benchTransition(Runner &runner, Image &image, SDL_Renderer *ren) {
+        const FrameLayers layers = makeLayers();
+        const FrameTextures textures {toTexture(layers.background, ren, SDL_BLENDMODE_NONE),
+                                      toTexture(layers.text, ren, SDL_BLENDMODE_BLEND),
+                                      toTexture(layers.icon, ren, SDL_BLENDMODE_BLEND)};
+        const std::function<void()> drawScene = [&] { drawFrame(ren, textures); };
+
+        // both scenes drawn live every frame, what a transition costs without the snapshots
+        if (runner.wants("Transition/live")) {
+            runner.run("Transition/live", 148 * 89, [&](uint64_t) {
+                drawFrame(ren, textures);
+                drawFrame(ren, textures);
+            });
+        }
+
+        Transition transition(image);
+        if (runner.wants("Transition::start")) {
+            runner.run("Transition::start", 148 * 89, [&](uint64_t) {
+                transition.start(ren, 148, 89, TransitionStyle::Fade, 220.0, drawScene, drawScene);
+            });
+        }
+
+        for (const TransitionStyle style : {TransitionStyle::Fade, TransitionStyle::SlideLeft}) {
+            const char *name = (style == TransitionStyle::Fade) ? "Transition::draw/fade" : "Transition::draw/slide";
+            if (!runner.wants(name))
+                continue;
+
+            // halfway through, the transition never ends while it is timed
+            transition.start(ren, 148, 89, style, 220.0, drawScene, drawScene);
+            transition.update(0.0);
+            transition.update(110.0);
+            runner.run(name, 148 * 89, [&](uint64_t) { transition.draw(ren); });
+        }
+
+        SDL_DestroyTexture(textures.background);
+        SDL_DestroyTexture(textures.text);
+        SDL_DestroyTexture(textures.icon);
+    }
+
+    // SDL truncates where the compositor rounds, a channel may differ by this much
+    constexpr int sdlTolerance = 3;
+
+    int verifyCompositor(SDL_Renderer *ren) {
+        const FrameLayers layers = makeLayers();
+        const FrameTextures textures {toTexture(layers.background, ren, SDL_BLENDMODE_NONE),
+                                      toTexture(layers.text, ren, SDL_BLENDMODE_BLEND),
+                                      toTexture(layers.icon, ren, SDL_BLENDMODE_BLEND)};
+
+        std::vector<uint32_t> expected(148 * 89);
+        drawFrame(ren, textures);
+        SDL_RenderReadPixels(ren, nullptr, SDL_PIXELFORMAT_ARGB8888, expected.data(), 148 * 4);
+
+        SDL_DestroyTexture(textures.background);
+        SDL_DestroyTexture(textures.text);
+        SDL_DestroyTexture(textures.icon);
+
+        int result = 0;
+        std::vector<uint32_t> scalar;
+        for (const Kernel kernel : {Kernel::Scalar, Kernel::SSE2, Kernel::AVX2}) {
+            if (!Compositor::isSupported(kernel))
+                continue;
+
+            Compositor compositor;
+            compositor.create(ren, 148, 89);
+            compositor.setKernel(kernel);
+            drawFrame(compositor, layers);
+            const std::vector<uint32_t> pixels(compositor.getPixels(), compositor.getPixels() + 148 * 89);
+
+            int maxDiff = 0;
+            size_t mismatches = 0;
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                for (int shift = 0; shift < 32; shift += 8) {
+                    const int diff = std::abs(static_cast<int>((pixels[i] >> shift) & 0xFF) -
+                                              static_cast<int>((expected[i] >> shift) & 0xFF));
+                    maxDiff = std::max(maxDiff, diff);
+                    mismatches += (diff > sdlTolerance) ? 1 : 0;
+                }
+            }
+
+            // the premultiplied, colour keyed & blurred layers have to match too
+            std::vector<uint32_t> premultiplied = pixels;
+            for (const Layer *layer : {&layers.background, &layers.text, &layers.icon})
+                premultiplied.insert(premultiplied.end(), layer->pixels.begin(), layer->pixels.end());
+            const size_t converted = premultiplied.size() - pixels.size();
+            premultiplyAlpha(premultiplied.data() + pixels.size(), converted, kernel);
+            std::vector<uint32_t> keyed(premultiplied.end() - static_cast<ptrdiff_t>(converted), premultiplied.end());
+            for (const uint8_t tolerance : {0, 1, 40})
+                colorKeyToAlpha(keyed.data(), keyed.size(), {255, 255, 255, 255}, tolerance, kernel);
+            premultiplied.insert(premultiplied.end(), keyed.begin(), keyed.end());
+            // the blurred frame (edges included) & an icon narrower than the box
+            std::vector<uint32_t> blurred = expected;
+            boxBlur(blurred.data(), 148, 89, 4, 3, kernel);
+            premultiplied.insert(premultiplied.end(), blurred.begin(), blurred.end());
+            blurred = layers.icon.pixels;
+            boxBlur(blurred.data(), layers.icon.w, layers.icon.h, 40, 1, kernel);
+            premultiplied.insert(premultiplied.end(), blurred.begin(), blurred.end());
+
+            // the frame with premultiplied text & icon layers, within a rounding of the straight alpha frame
+            FrameLayers premultipliedLayers = layers;
+            for (Layer *layer : {&premultipliedLayers.text, &premultipliedLayers.icon}) {
+                premultiplyAlpha(layer->pixels.data(), layer->pixels.size(), kernel);
+                layer->premultiplied = true;
+            }
+            compositor.copy(layers.background, 0, 0);
+            compositor.fillRect({4, 4, 140, 40}, menuFill);
+            compositor.blend(premultipliedLayers.text, &textClip, 14, 56, premultiplyMod(textMod));
+            compositor.fillRect({120, 6, 22, 12}, buttonFill);
+            compositor.blend(premultipliedLayers.icon, nullptr, 123, 4, premultiplyMod(iconMod));
+            int premultipliedDiff = 0;
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                for (int shift = 0; shift < 32; shift += 8) {
+                    const int diff = std::abs(static_cast<int>((compositor.getPixels()[i] >> shift) & 0xFF) -
+                                              static_cast<int>((pixels[i] >> shift) & 0xFF));
+                    premultipliedDiff = std::max(premultipliedDiff, diff);
+                }
+            }
+            premultiplied.insert(premultiplied.end(), compositor.getPixels(), compositor.getPixels() + pixels.size());
+
+            if (kernel == Kernel::Scalar)
+                scalar = premultiplied;
+            const bool sameAsScalar = premultiplied == scalar;
+
+            std::cerr << std::format("verify {:<8} max difference to SDL {}, {} channels over {}, premultiplied {}, "
+                                     "{}\n",
+                                     Compositor::getKernelName(kernel), maxDiff, mismatches, sdlTolerance,
+                                     premultipliedDiff, sameAsScalar ? "same as scalar" : "DIFFERS FROM SCALAR");
+            if (mismatches != 0 || premultipliedDiff > sdlTolerance || !sameAsScalar)
+                result = -1;
+        }
+
+        return result;
+    }
+
+    // buttons as the interface draws them: a translucent fill, two outlines & a stretched icon
+    void drawButtons(Batch &batch, SDL_Renderer *ren, SDL_Texture *icon, const Layer &layer) {
+        for (const SDL_Rect &box : {SDL_Rect {5, 5, 25, 25}, SDL_Rect {39, 5, 12, 12}, SDL_Rect {60, 30, 16, 16},
+                                    SDL_Rect {140, 80, 20, 20}}) {
+            batch.fillRect(box, {67, 48, 46, 200}, ren);
+            batch.drawRect({box.x - 1, box.y - 1, box.w + 2, box.h + 2}, {168, 124, 116, 200}, ren);
+            batch.drawRect({box.x - 2, box.y - 2, box.w + 4, box.h + 4}, {168, 124, 116, 200}, ren);
+            SDL_SetTextureColorMod(icon, 240, 209, 189);
+            SDL_SetTextureAlphaMod(icon, 200);
+            batch.drawTexture(icon, nullptr, box, ren, &layer);
+        }
+        batch.flush(ren);
+    }
+
+    int verifyDrawTarget(SDL_Renderer *ren) {
+        const FrameLayers layers = makeLayers();
+        SDL_Texture *icon = toTexture(layers.icon, ren, SDL_BLENDMODE_BLEND);
+        SDL_Texture *background = toTexture(layers.background, ren, SDL_BLENDMODE_NONE);
+
+        // the renderer call by call (SDL_RenderFillRect & SDL_RenderCopy) is what the compositor matches
+        Batch batch;
+        batch.setImmediate(true);
+        SDL_RenderCopy(ren, background, nullptr, nullptr);
+        drawButtons(batch, ren, icon, layers.icon);
+        std::vector<uint32_t> expected(148 * 89);
+        SDL_RenderReadPixels(ren, nullptr, SDL_PIXELFORMAT_ARGB8888, expected.data(), 148 * 4);
+
+        Compositor compositor;
+        compositor.create(ren, 148, 89);
+        compositor.copy(layers.background, 0, 0);
+        batch.setDrawTarget(&compositor);
+        drawButtons(batch, ren, icon, layers.icon);
+        SDL_DestroyTexture(icon);
+        SDL_DestroyTexture(background);
+
+        int maxDiff = 0;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                const int diff = std::abs(static_cast<int>((compositor.getPixels()[i] >> shift) & 0xFF) -
+                                          static_cast<int>((expected[i] >> shift) & 0xFF));
+                maxDiff = std::max(maxDiff, diff);
+                mismatches += (diff > sdlTolerance) ? 1 : 0;
+            }
+        }
+
+        std::cerr << std::format("verify batch    max difference to SDL {}, {} channels over {}\n", maxDiff,
+                                 mismatches, sdlTolerance);
+
+        return (mismatches == 0) ? 0 : -1;
+    }
+
+    int verifyRelease(SDL_Renderer *ren, const Options &options) {
+        // the main scene's manifest, the gif is packed on load & its canvas removed on release
+        Image image;
+        image.setKeepLayers(true);
+        ImageHandle canvas {};
+        Scene scene;
+        scene.createScene(0, "Main");
+        scene.createScene(1, "Settings");
+        scene.setManifest(0, {[&] {
+                                  canvas = image.createPack("canvas", options.assets + "gif-extract/", ren);
+                                  return canvas ? 0 : -1;
+                              },
+                              [&] { image.remove(canvas); }, {}});
+        scene.setReleaseDelay(std::chrono::milliseconds(0));
+
+        // layers count towards the budget, they have to be given back as well
+        const size_t baseline = image.getTextureBytes() + image.getLayerBytes();
+        size_t loaded = 0;
+        size_t released = 0;
+        for (int cycle = 0; cycle < 2; ++cycle) {
+            scene.setScene(0);
+            loaded = image.getTextureBytes() + image.getLayerBytes();
+            scene.setScene(1);
+            scene.update(Clock::now() + std::chrono::seconds(1));
+            released = image.getTextureBytes() + image.getLayerBytes();
+        }
+
+        std::cerr << std::format("verify release  {} texture & layer bytes loaded, {} left after release ({} before)\n",
+                                 loaded, released, baseline);
+
+        return (loaded > baseline && released == baseline) ? 0 : -1;
+    }
+
+    void benchScene(Runner &runner) {
+        for (const int count : {8, 64, 512}) {
+            Scene scene;
+            std::vector<std::basic_string<char>> names;
+            for (int i = 0; i < count; ++i)
+                names.push_back(std::format("Scene-{}", i));
+            for (int i = 0; i < count; ++i)
+                scene.createScene(static_cast<SceneID>(i), names[static_cast<size_t>(i)]);
+
+            // the last scene is the worst case of the linear search
+            if (runner.wants("Scene::findScene"))
+                runner.run("Scene::findScene", count, [&](uint64_t) { keep(scene.findScene(names.back())); });
+
+            // the per-frame manifest check, every scene loaded & none of them due for release
+            if (runner.wants("Scene::update")) {
+                for (int i = 0; i < count; ++i)
+                    scene.setManifest(static_cast<SceneID>(i), {[] { return 0; }, [] {}, {}});
+                for (int i = 0; i < count; ++i)
+                    scene.setScene(static_cast<SceneID>(i));
+
+                const Clock::time_point now = Clock::now();
+                runner.run("Scene::update", count, [&](uint64_t) { scene.update(now); });
+            }
+        }
+    }
+
+    void benchTime(Runner &runner) {
+        if (!runner.wants("Anya::timeToStr"))
+            return;
+
+        const auto now = std::chrono::system_clock::now();
+        runner.run("Anya::timeToStr", 1,
+                   [&](uint64_t i) { keep(Anya::timeToStr(now + std::chrono::minutes(i % 1440)).size()); });
+    }
+
+    int parse(int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--filter" && hasValue) {
+                options.filter = argv[++i];
+            } else if (arg == "--out" && hasValue) {
+                options.outFile = argv[++i];
+            } else if (arg == "--min-time" && hasValue) {
+                options.minTime = std::max(std::atof(argv[++i]), 1.0);
+            } else if (arg == "--verify") {
+                options.verify = true;
+            } else if (arg == "--assets" && hasValue) {
+                options.assets = argv[++i];
+                if (!options.assets.ends_with('/'))
+                    options.assets += '/';
+            } else {
+                std::cerr << "usage: anya_bench [--filter <text>] [--out <file>] [--min-time <ms>] [--assets <dir>] "
+                             "[--verify]\n";
+                return -1;
+            }
+        }
+
+        return 0;
+    }
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (parse(argc, argv, options) != 0)
+        return 1;
+
+    SDL_SetMainReady();
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    if (SDL_Init(SDL_INIT_VIDEO) != 0 || TTF_Init() != 0 || IMG_Init(IMG_INIT_PNG) == 0) {
+        std::cerr << "Failed to initialize: " << SDL_GetError() << '\n';
+        return 1;
+    }
+
+    // software renderer drawing into a surface, the size of the main window
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 148, 89, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *ren = (target != nullptr) ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (ren == nullptr) {
+        std::cerr << "Failed to create the renderer: " << SDL_GetError() << '\n';
+        return 1;
+    }
+
+    int result = 0;
+    if (options.verify) {
+        result = verifyCompositor(ren);
+        if (verifyDrawTarget(ren) != 0)
+            result = -1;
+        if (verifyRelease(ren, options) != 0)
+            result = -1;
+    } else {
+        Runner runner(options);
+        Image image;
+
+        benchText(runner, image, ren, options);
+        benchImage(runner, image, ren, options);
+        benchAnimation(runner, ren);
+        benchInterface(runner, image, ren);
+        benchWorldClock(runner, image, ren, options);
+        benchScene(runner);
+        benchTime(runner);
+        benchCompositor(runner, ren);
+        benchTransition(runner, image, ren);
+
+        result = runner.write();
+        image.clearFonts();
+    }
+
+    SDL_DestroyRenderer(ren);
+    SDL_FreeSurface(target);
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+
+    return (result == 0) ? 0 : 1;
+}
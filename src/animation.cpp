@@ -1,7 +1,9 @@
 #include "animation.hpp"
+#include "memory.hpp"
 
 namespace Application::Helper {
     void Animation::addAnimation(int frames, int x, int y, int w, int h) {
+        MemoryScope scope(MemTag::Animation);
         SDL_assert(frames != 0);
 
         for (int i = 0; i < frames; ++i) {
@@ -21,18 +23,29 @@ namespace Application::Helper {
         }
     }
 
-    void Animation::draw(IMD &img, SDL_Renderer *ren, int x, int y, double scale) {
-        SDL_Rect clip = frames[currentFrame];
-        SDL_Rect dst {x, y, clip.w, clip.h};
+    void Animation::draw(SDL_Texture *texture, SDL_Renderer *ren, int x, int y, double scale) {
+        SDL_Rect clip {0};
+        SDL_Rect dst {0};
+        if (getRects(x, y, scale, clip, dst))
+            SDL_RenderCopy(ren, texture, &clip, &dst);
+    }
+
+    bool Animation::getRects(int x, int y, double scale, SDL_Rect &clip, SDL_Rect &dst) const {
+        const auto iter = frames.find(static_cast<unsigned int>(currentFrame));
+        if (iter == frames.end())
+            return false;
 
+        clip = iter->second;
+        dst = {x, y, clip.w, clip.h};
         if (scale != 0) {
             dst.w *= static_cast<int>(scale);
             dst.h *= static_cast<int>(scale);
-        } else if (scale < 0) {
-            dst.w *= 1;
-            dst.h *= 1;
         }
 
-        SDL_RenderCopy(ren, img->texture.get(), &clip, &dst);
+        return true;
+    }
+
+    int Animation::getFrame() const noexcept {
+        return currentFrame;
     }
 } // namespace Application::Helper
@@ -28,13 +28,28 @@ namespace Application::Helper {
         void update(float speed, double dt);
         /** Renders the animation to the screen
          *
-         * \param img -> the animation to draw
+         * \param texture -> the animation (image pack canvas) to draw
          * \param ren -> the renderer to use
          * \param x -> x position of the animation
          * \param y -> y position of the animation
          * \param scale -> scale the animation width and height up or down (0 is the lowest it can go)
          */
-        void draw(IMD &img, SDL_Renderer *ren, int x, int y, double scale = 0.0);
+        void draw(SDL_Texture *texture, SDL_Renderer *ren, int x, int y, double scale = 0.0);
+        /** Gets where the current frame is in the canvas & where it is drawn.
+         *
+         * \param x -> x position of the animation
+         * \param y -> y position of the animation
+         * \param scale -> scale the animation width and height up or down (0 is the lowest it can go)
+         * \param clip -> the frame in the canvas
+         * \param dst -> where the frame is drawn
+         * \return true if there is a frame, otherwise false.
+         */
+        bool getRects(int x, int y, double scale, SDL_Rect &clip, SDL_Rect &dst) const;
+        /** Gets the frame that is drawn.
+         *
+         * \return the index of the current frame.
+         */
+        int getFrame() const noexcept;
 
     private:
         float frameTime {0.0f};
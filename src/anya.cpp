@@ -2,10 +2,24 @@
 #include "anya.hpp"
 #include "nfd.hpp"
 #include <array>
+#include <csignal>
+#include <cstdio>
 #include <iostream>
 
 namespace Application {
-    Anya::Anya() {
+    namespace {
+        // set by F4 or SIGUSR1, the report is printed at the end of the next frame
+        volatile std::sig_atomic_t memoryDumpRequested = 0;
+
+        void requestMemoryDump(int) {
+            memoryDumpRequested = 1;
+        }
+    } // namespace
+
+    Anya::Anya(const LaunchOptions &options) : options(options) {
+        if (!options.traceFile.empty())
+            Helper::traceStart(options.traceFile);
+
         if (!boot()) {
             SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Anya App Error",
                                      "BOOT FAILURE: Window or Renderer not initialized.\n\n"
@@ -33,6 +47,24 @@ namespace Application {
 #endif
 
     bool Anya::boot() {
+        Helper::TraceScope scope("boot");
+
+        // a replay runs headless, its events come from the recording
+        if (!options.replayFile.empty()) {
+            if (replay.load(options.replayFile) != 0)
+                return false;
+
+            SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        } else if (!options.recordFile.empty()) {
+            replay.record(options.recordFile);
+        }
+
+        power.setProfile(Helper::PowerPolicy::parseProfile(options.powerProfile));
+
+#ifdef SIGUSR1
+        std::signal(SIGUSR1, requestMemoryDump);
+#endif
+
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) != 0) {
             panicln("Failed to initialize SDL");
             return false;
@@ -89,75 +121,95 @@ namespace Application {
 
         // initialize components
         imagePtr = std::make_unique<Helper::Image>();
-        interfacePtr = std::make_unique<Helper::UInterface>();
+        interfacePtr = std::make_unique<Helper::UInterface>(*imagePtr);
         scenePtr = std::make_unique<Helper::Scene>();
+        transitionPtr = std::make_unique<Helper::Transition>(*imagePtr);
+        // the software renderer has no custom blend modes, only the layers the compositor blends are premultiplied
+        if (options.alphaMode == "premultiplied")
+            imagePtr->setPremultipliedAlpha(renderer.get(), true);
+        // the software renderer's generic blitters are slower than compositing on the cpu, images keep a copy there
+        compositing = options.drawMode != "sdl";
+        imagePtr->setKeepLayers(compositing);
 
         // set the default font
         typographyStr = dirPath + "assets/Onest.ttf";
 
-        // load assets
-        backgroundGIF = imagePtr->createPack("canvas", dirPath + "assets/gif-extract/", renderer.get());
-        // default background image to use
-        githubImg = imagePtr->createImage(dirPath + "assets/25231.png", renderer.get());
-        calendarImg = imagePtr->createImage(dirPath + "assets/calendar.png", renderer.get());
-        typographyImg = imagePtr->createImage(dirPath + "assets/typography.png", renderer.get());
-        returnImg = imagePtr->createImage(dirPath + "assets/return.png", renderer.get());
-        setThemeImg = imagePtr->createImage(dirPath + "assets/paintbrush.png", renderer.get());
+        // the other time zones share one glyph atlas, an unknown zone is skipped
+        worldClockPtr = std::make_unique<Helper::WorldClock>(*imagePtr);
+        if (!options.clockZones.empty() && worldClockPtr->create(renderer.get(), typographyStr, 9) == 0) {
+            for (const std::basic_string<char> &zone : options.clockZones)
+                worldClockPtr->addClock(zone);
+        }
+
+        // declare assets, they are loaded by the manifest of the scene that shows them
+        githubImg = imagePtr->declareImage(dirPath + "assets/25231.png");
+        calendarImg = imagePtr->declareImage(dirPath + "assets/calendar.png");
+        typographyImg = imagePtr->declareImage(dirPath + "assets/typography.png");
+        returnImg = imagePtr->declareImage(dirPath + "assets/return.png");
+        setThemeImg = imagePtr->declareImage(dirPath + "assets/paintbrush.png");
         imagePtr->getAnimPtr()->addAnimation(68, 0, 0, 148, 89);
 
         // create scenes
-        scenePtr->createScene("Main");
-        scenePtr->createScene("Minimal-Main");
-        scenePtr->createScene("Settings");
-        scenePtr->createScene("Settings-Themes");
-        scenePtr->createScene("Theme-Creator");
+        for (Helper::SceneID id = 0; id < Scenes::Count; ++id)
+            scenePtr->createScene(id, sceneNames[id]);
+
+        // the gif is built on the first frame of main (the default background), the menus draw it under themselves &
+        // keep it loaded
+        scenePtr->setManifest(Scenes::Main, {[this] { return loadBackgroundGIF(); },
+                                             [this] { imagePtr->remove(backgroundGIF); }, {Scenes::Settings}});
+        scenePtr->setManifest(Scenes::MinimalMain, imageManifest({returnImg}, {Scenes::SettingsThemes}));
+        scenePtr->setManifest(Scenes::Settings, imageManifest({githubImg, calendarImg},
+                                                              {Scenes::Main, Scenes::SettingsThemes}));
+        scenePtr->setManifest(Scenes::SettingsThemes, imageManifest({typographyImg, setThemeImg},
+                                                                    {Scenes::Settings, Scenes::Main,
+                                                                     Scenes::MinimalMain, Scenes::ThemeCreator}));
+        scenePtr->setManifest(Scenes::ThemeCreator, imageManifest({}, {Scenes::SettingsThemes, Scenes::Main}));
+        scenePtr->setReleaseDelay(std::chrono::seconds(std::max(options.releaseAfter, 0)));
 
         // main
-        settingsBtn = interfacePtr->createButton("+", "Main", 5, 5, 20, 20);
+        settingsBtn = interfacePtr->createButton("+", Scenes::Main, 5, 5, 20, 20);
 
         // Minimal-Main
-        mainQuitBtn = interfacePtr->createButton("x", "Minimal-Main", 103, 5, 12, 12);
-        mainQuitBtn->canQuit = true;
-        minimizeBtn = interfacePtr->createButton("-", "Minimal-Main", 85, 5, 12, 12);
-        minimizeBtn->canMinimize = true;
-        returnBtn = interfacePtr->createButton("", "Minimal-Main", returnImg, 67, 5, 12, 12);
+        mainQuitBtn = interfacePtr->createButton("x", Scenes::MinimalMain, 103, 5, 12, 12);
+        interfacePtr->setFlag(mainQuitBtn, Helper::ButtonCanQuit, true);
+        minimizeBtn = interfacePtr->createButton("-", Scenes::MinimalMain, 85, 5, 12, 12);
+        interfacePtr->setFlag(minimizeBtn, Helper::ButtonCanMinimize, true);
+        returnBtn = interfacePtr->createButton("", Scenes::MinimalMain, returnImg, 67, 5, 12, 12);
 
         // settings
-        settingsQuitBtn = interfacePtr->createButton("Quit", "Settings", 108, 5, 35, 25);
-        settingsQuitBtn->canQuit = true;
-        settingsExitBtn = interfacePtr->createButton("x", "Settings", 65, 60, 20, 20);
-        themesBtn = interfacePtr->createButton("Themes", "Settings", 39, 5, 60, 25);
-        githubBtn = interfacePtr->createButton("", "Settings", githubImg, 5, 5, 25, 25);
-        calendarBtn = interfacePtr->createButton("", "Settings", calendarImg, 5, 39, 25, 25);
+        settingsQuitBtn = interfacePtr->createButton("Quit", Scenes::Settings, 108, 5, 35, 25);
+        interfacePtr->setFlag(settingsQuitBtn, Helper::ButtonCanQuit, true);
+        settingsExitBtn = interfacePtr->createButton("x", Scenes::Settings, 65, 60, 20, 20);
+        themesBtn = interfacePtr->createButton("Themes", Scenes::Settings, 39, 5, 60, 25);
+        githubBtn = interfacePtr->createButton("", Scenes::Settings, githubImg, 5, 5, 25, 25);
+        calendarBtn = interfacePtr->createButton("", Scenes::Settings, calendarImg, 5, 39, 25, 25);
 
         // settings-themes
-        themesExitBtn = interfacePtr->createButton("x", "Settings-Themes", 65, 60, 20, 20);
-        minimalBtn = interfacePtr->createButton("Minimal", "Settings-Themes", 39, 5, 55, 25);
-        setBGBtn = interfacePtr->createButton("Set BG", "Settings-Themes", 103, 5, 40, 25);
-        openFileBtn = interfacePtr->createButton("Open File", "Settings-Themes", 25, 35, 50, 15);
-        bgColorInputBtn = interfacePtr->createButton("Set Color", "Settings-Themes", 80, 35, 50, 15);
-        setTypographyBtn = interfacePtr->createButton("", "Settings-Themes", typographyImg, 5, 5, 25, 25);
+        themesExitBtn = interfacePtr->createButton("x", Scenes::SettingsThemes, 65, 60, 20, 20);
+        minimalBtn = interfacePtr->createButton("Minimal", Scenes::SettingsThemes, 39, 5, 55, 25);
+        setBGBtn = interfacePtr->createButton("Set BG", Scenes::SettingsThemes, 103, 5, 40, 25);
+        openFileBtn = interfacePtr->createButton("Open File", Scenes::SettingsThemes, 25, 35, 50, 15);
+        bgColorInputBtn = interfacePtr->createButton("Set Color", Scenes::SettingsThemes, 80, 35, 50, 15);
+        setTypographyBtn = interfacePtr->createButton("", Scenes::SettingsThemes, typographyImg, 5, 5, 25, 25);
         typographyInputBtn =
-            interfacePtr->createButton("Set Font", "Settings-Themes", setTypographyBtn->box.w / 2, 35, 120, 15);
-        setThemeBtn = interfacePtr->createButton("", "Settings-Themes", setThemeImg, 5, 39, 25, 25);
+            interfacePtr->createButton("Set Font", Scenes::SettingsThemes,
+                                       interfacePtr->getButtonRect(setTypographyBtn).w / 2, 35, 120, 15);
+        setThemeBtn = interfacePtr->createButton("", Scenes::SettingsThemes, setThemeImg, 5, 39, 25, 25);
 
         // theme-creator
-        exitThemeCreatorBtn = interfacePtr->createButton("x", "Theme-Creator", 30, 74, 12, 12);
-        setMenuBGBtn = interfacePtr->createButton("Menu BG", "Theme-Creator", 13, 5, 48, 12);
-        setButtonBGCBtn = interfacePtr->createButton("BKGD", "Theme-Creator", 13, 22, 48, 12);
-        setButtonOCBtn = interfacePtr->createButton("Outline", "Theme-Creator", 13, 39, 48, 12);
-        setButtonTCBtn = interfacePtr->createButton("Text", "Theme-Creator", 13, 56, 48, 12);
+        exitThemeCreatorBtn = interfacePtr->createButton("x", Scenes::ThemeCreator, 30, 74, 12, 12);
+        setMenuBGBtn = interfacePtr->createButton("Menu BG", Scenes::ThemeCreator, 13, 5, 48, 12);
+        setButtonBGCBtn = interfacePtr->createButton("BKGD", Scenes::ThemeCreator, 13, 22, 48, 12);
+        setButtonOCBtn = interfacePtr->createButton("Outline", Scenes::ThemeCreator, 13, 39, 48, 12);
+        setButtonTCBtn = interfacePtr->createButton("Text", Scenes::ThemeCreator, 13, 56, 48, 12);
         buttonColorInputBtn =
-            interfacePtr->createButton("Input", "Theme-Creator", ((int)windowWidth / 2) + 11, 76, 62, 12);
+            interfacePtr->createButton("Input", Scenes::ThemeCreator, ((int)windowWidth / 2) + 11, 76, 62, 12);
 
-        for (auto &button : interfacePtr->getButtonList())
+        for (Helper::ButtonID button = 0; button < interfacePtr->getButtonCount(); ++button)
             interfacePtr->setButtonTheme(button, {{67, 48, 46}, {168, 124, 116}, {240, 209, 189}});
 
-        imagePtr->setTextureColor(githubImg, {240, 209, 189, (uint8_t)githubBtn->colorAlpha});
-        imagePtr->setTextureColor(calendarImg, {240, 209, 189, (uint8_t)calendarBtn->colorAlpha});
-        imagePtr->setTextureColor(typographyImg, {240, 209, 189, (uint8_t)setTypographyBtn->colorAlpha});
-        imagePtr->setTextureColor(returnImg, {240, 209, 189, (uint8_t)returnBtn->colorAlpha});
-        imagePtr->setTextureColor(setThemeImg, {240, 209, 189, (uint8_t)setThemeBtn->colorAlpha});
+        // labels are sized from the button boxes
+        interfacePtr->setLabelFont(dirPath + "assets/Onest.ttf");
 
         // extras
         settingsView = {0, 0, static_cast<int>(windowWidth), static_cast<int>(windowHeight)};
@@ -168,6 +220,9 @@ namespace Application {
         colorSliderBounds = {static_cast<int>(windowWidth / 2), 0, 8, 89};
         themesColorPicker = {0, 0, 10, 10};
 
+        colorPickerPtr = std::make_unique<Helper::ColorPicker>();
+        colorPickerPtr->create(renderer.get(), colorPickerBounds, colorSliderBounds);
+
         // center
         themesSliderOutline[0].position.x = static_cast<float>((windowWidth / 2) + 12);
         themesSliderOutline[0].position.y = 50.0f; // follows mouse cursor when pressed on
@@ -194,8 +249,16 @@ namespace Application {
         themesSlider[2].position.y = 55.0f;
         themesSlider[2].color = {255, 255, 255, 255};
 
+        // only the buttons of the shown scene are enabled, textures the new scene does not use can be evicted
+        interfacePtr->setHitArea(static_cast<int>(windowWidth), static_cast<int>(windowHeight));
+        scenePtr->addChangeHook([this](Helper::SceneID previous, Helper::SceneID current) {
+            interfacePtr->setActiveLayer(current);
+            imagePtr->markSceneChange();
+            startTransition(previous, current);
+        });
+
         // set the scene to be displayed
-        scenePtr->setScene("Main");
+        scenePtr->setScene(Scenes::Main);
 
         shouldRun = true;
 
@@ -204,160 +267,215 @@ namespace Application {
 
     void Anya::update() {
         while (shouldRun) {
-            SDL_PollEvent(&ev);
+            Helper::TraceScope frame("frame");
+            // sleep until the next event when nothing on screen moves, the clock only changes once a minute
+            const auto frameStart = std::chrono::steady_clock::now();
+            // a minimized or hidden window waits for the event that shows it again (replays always draw)
+            const bool visible = power.isVisible() || replay.isReplaying();
+            const bool idle = !visible || (interfacePtr->nextTweenCompletion() < 0.0 && !isAnimating() &&
+                                           !replay.isReplaying() && !scenePtr->isPrefetching() &&
+                                           !transitionPtr->isActive());
+            if (replay.isReplaying()) {
+                // the dummy window's own events are not part of the session
+                SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+                if (!replay.poll(ev))
+                    ev.type = SDL_FIRSTEVENT;
+            } else if ((idle ? SDL_WaitEventTimeout(&ev, visible ? idleTimeout() : -1) : SDL_PollEvent(&ev)) == 0) {
+                ev.type = SDL_FIRSTEVENT; // no event, do not handle the last one again
+            } else {
+                replay.write(ev);
+            }
+            Helper::traceInput(ev);
+            profiler.lap(idle ? Helper::Phase::Sleep : Helper::Phase::Events);
 
             switch (ev.type) {
                 case SDL_QUIT: {
                     shouldRun = false;
                 } break;
 
+                case SDL_WINDOWEVENT: {
+                    // the time spent hidden is not animated
+                    if (power.handleEvent(ev.window))
+                        begin = std::chrono::steady_clock::now();
+                } break;
+
                 case SDL_MOUSEBUTTONDOWN: {
-                    for (auto &button : interfacePtr->getButtonList()) {
-                        if (interfacePtr->cursorInBounds(button, interfacePtr->getMousePos())) {
-                            if (button->isEnabled) {
-                                if (button->canMinimize)
-                                    if (scenePtr->getCurrentScene() == scenePtr->findScene("Minimal-Main"))
-                                        SDL_MinimizeWindow(window.get());
-
-                                if (button->canQuit) {
-                                    if (scenePtr->getCurrentScene() == scenePtr->findScene("Settings"))
-                                        shouldRun = false;
-
-                                    if (scenePtr->getCurrentScene() == scenePtr->findScene("Minimal-Main"))
-                                        shouldRun = false;
-                                }
+                    // only the buttons of the current scene under the cursor
+                    for (Helper::ButtonID button : interfacePtr->getButtonsAt(interfacePtr->getMousePos())) {
+                        if (interfacePtr->hasFlag(button, Helper::ButtonCanMinimize))
+                            if (scenePtr->getCurrentScene() == Scenes::MinimalMain)
+                                SDL_MinimizeWindow(window.get());
+
+                        if (interfacePtr->hasFlag(button, Helper::ButtonCanQuit)) {
+                            if (scenePtr->getCurrentScene() == Scenes::Settings)
+                                shouldRun = false;
+
+                            if (scenePtr->getCurrentScene() == Scenes::MinimalMain)
+                                shouldRun = false;
+                        }
 
-                                if (button == settingsBtn)
-                                    scenePtr->setScene("Settings");
+                        if (button == settingsBtn)
+                            scenePtr->setScene(Scenes::Settings);
 
-                                if (button == githubBtn) {
+                        if (button == githubBtn) {
 #ifdef _WIN32
-                                    ShellExecuteA(0, 0, "https://www.github.com/inohime", 0, 0, SW_SHOW);
+                            ShellExecuteA(0, 0, "https://www.github.com/inohime", 0, 0, SW_SHOW);
 #elif defined __linux__
-                                    system("xdg-open https://www.github.com/inohime");
+                            system("xdg-open https://www.github.com/inohime");
 #endif
-                                }
+                        }
 
-                                if (button == settingsExitBtn)
-                                    scenePtr->setScene("Main");
+                        if (button == settingsExitBtn)
+                            scenePtr->setScene(Scenes::Main);
 
-                                if (button == themesBtn)
-                                    scenePtr->setScene("Settings-Themes");
+                        if (button == themesBtn)
+                            scenePtr->setScene(Scenes::SettingsThemes);
 
-                                if (button == calendarBtn && !showDate) {
-                                    showDate = true;
-                                } else if (button == calendarBtn && showDate) {
-                                    showDate = false;
-                                }
+                        if (button == calendarBtn && !showDate) {
+                            showDate = true;
+                        } else if (button == calendarBtn && showDate) {
+                            showDate = false;
+                        }
 
-                                if (button == setBGBtn && !setBGIsPressed) {
-                                    if (setTypographyIsPressed) {
-                                        setTypographyIsPressed = false;
-                                    }
+                        if (button == setBGBtn && !setBGIsPressed) {
+                            if (setTypographyIsPressed) {
+                                setTypographyIsPressed = false;
+                            }
 
-                                    setBGIsPressed = true;
-                                } else if (button == setBGBtn && setBGIsPressed) {
-                                    setBGIsPressed = false;
-                                    bgColorInputBtn->text = "Set Color";
-                                }
+                            setBGIsPressed = true;
+                        } else if (button == setBGBtn && setBGIsPressed) {
+                            setBGIsPressed = false;
+                            interfacePtr->getButtonText(bgColorInputBtn) = "Set Color";
+                        }
 
-                                if (button == openFileBtn && setBGIsPressed) {
-                                    // this operation increases memory usage substantially
-                                    NFD::UniquePath filePath = nullptr;
-                                    const nfdfilteritem_t filterItem[1] = {"Image formats (*.jpg, *.jpeg, *.png)",
-                                                                           "jpg,jpeg,png"};
-                                    nfdresult_t result = NFD::OpenDialog(filePath, filterItem, 1, NULL);
+                        if (button == openFileBtn && setBGIsPressed) {
+                            // this operation increases memory usage substantially
+                            NFD::UniquePath filePath = nullptr;
+                            const nfdfilteritem_t filterItem[1] = {"Image formats (*.jpg, *.jpeg, *.png)",
+                                                                   "jpg,jpeg,png"};
+                            nfdresult_t result = NFD::OpenDialog(filePath, filterItem, 1, NULL);
 #ifdef _DEBUG
-                                    if (result == NFD_OKAY) {
-                                        std::cout << "Success!\n";
-                                        std::cout << filePath.get() << '\n';
-                                    } else if (result == NFD_CANCEL) {
-                                        std::cout << "Canceled file dialog operation\n";
-                                    } else {
-                                        std::cout << "Error: " << NFD_GetError() << '\n';
-                                    }
+                            if (result == NFD_OKAY) {
+                                std::cout << "Success!\n";
+                                std::cout << filePath.get() << '\n';
+                            } else if (result == NFD_CANCEL) {
+                                std::cout << "Canceled file dialog operation\n";
+                            } else {
+                                std::cout << "Error: " << NFD_GetError() << '\n';
+                            }
 #endif
-                                    if (result == NFD_OKAY) {
-                                        if (setBGToColor)
-                                            setBGToColor = false;
-
-                                        backgroundImg = imagePtr->createImage(filePath.get(), renderer.get());
-                                        setBGtoImg = true;
-                                    } else if (result == NFD_CANCEL) {
-                                        break;
-                                    }
-                                }
+                            if (result == NFD_OKAY) {
+                                if (setBGToColor)
+                                    setBGToColor = false;
+
+                                const SDL_Point windowSize = {static_cast<int>(windowWidth),
+                                                              static_cast<int>(windowHeight)};
+                                backgroundImg =
+                                    imagePtr->createImage(filePath.get(), renderer.get(), nullptr, &windowSize);
+                                setBGtoImg = true;
+                            } else if (result == NFD_CANCEL) {
+                                break;
+                            }
+                        }
 
-                                if (button == bgColorInputBtn) {
-                                    if (setBGtoImg)
-                                        setBGtoImg = false;
+                        if (button == bgColorInputBtn) {
+                            if (setBGtoImg)
+                                setBGtoImg = false;
 
-                                    if (!setTypographyIsPressed)
-                                        bgColorInputBtn->text = "";
-                                }
+                            if (!setTypographyIsPressed)
+                                interfacePtr->getButtonText(bgColorInputBtn) = "";
+                        }
 
-                                if (button == setTypographyBtn && !setTypographyIsPressed) {
-                                    if (setBGIsPressed) {
-                                        setBGIsPressed = false;
-                                    }
+                        if (button == setTypographyBtn && !setTypographyIsPressed) {
+                            if (setBGIsPressed) {
+                                setBGIsPressed = false;
+                            }
 
-                                    setTypographyIsPressed = true;
-                                } else if (button == setTypographyBtn && setTypographyIsPressed) {
-                                    setTypographyIsPressed = false;
-                                    typographyInputBtn->text = "Set Font";
-                                }
+                            setTypographyIsPressed = true;
+                        } else if (button == setTypographyBtn && setTypographyIsPressed) {
+                            setTypographyIsPressed = false;
+                            interfacePtr->getButtonText(typographyInputBtn) = "Set Font";
+                        }
 
-                                if (button == typographyInputBtn) {
-                                    if (!setBGIsPressed && setTypographyIsPressed)
-                                        typographyInputBtn->text = "";
-                                }
+                        if (button == typographyInputBtn) {
+                            if (!setBGIsPressed && setTypographyIsPressed)
+                                interfacePtr->getButtonText(typographyInputBtn) = "";
+                        }
 
-                                if (button == minimalBtn) {
-                                    SDL_SetWindowBordered(window.get(), SDL_FALSE);
-                                    SDL_SetWindowSize(window.get(), minWindowWidth, minWindowHeight);
+                        if (button == minimalBtn) {
+                            SDL_SetWindowBordered(window.get(), SDL_FALSE);
+                            SDL_SetWindowSize(window.get(), minWindowWidth, minWindowHeight);
 #ifdef _WIN32
-                                    setWindowShadow(hwnd, {0, 0, 0, 1});
+                            setWindowShadow(hwnd, {0, 0, 0, 1});
 #endif
-                                    scenePtr->setScene("Minimal-Main");
-                                }
+                            scenePtr->setScene(Scenes::MinimalMain);
+                        }
 
-                                if (button == setThemeBtn) {
-                                    scenePtr->setScene("Theme-Creator");
-                                }
+                        if (button == setThemeBtn) {
+                            scenePtr->setScene(Scenes::ThemeCreator);
+                        }
 
-                                if (button == exitThemeCreatorBtn) {
-                                    scenePtr->setScene("Settings-Themes");
-                                }
+                        if (button == exitThemeCreatorBtn) {
+                            scenePtr->setScene(Scenes::SettingsThemes);
+                        }
+
+                        // the picked colour is swapped into the palette, labels & icons are tinted when drawn
+                        if (button == setMenuBGBtn)
+                            menuColor = pickedColor;
+
+                        if (button == setButtonBGCBtn || button == setButtonOCBtn || button == setButtonTCBtn) {
+                            Helper::ColorData palette = interfacePtr->getButtonTheme(button);
+                            if (button == setButtonBGCBtn)
+                                palette.bgColor = pickedColor;
+                            else if (button == setButtonOCBtn)
+                                palette.outlineColor = pickedColor;
+                            else
+                                palette.textColor = pickedColor;
+
+                            interfacePtr->setPalette(interfacePtr->getButtonThemeIndex(button), palette);
+                        }
 
-                                if (button == returnBtn) {
-                                    SDL_SetWindowBordered(window.get(), SDL_TRUE);
-                                    SDL_SetWindowSize(window.get(), windowWidth, windowHeight);
+                        if (button == returnBtn) {
+                            SDL_SetWindowBordered(window.get(), SDL_TRUE);
+                            SDL_SetWindowSize(window.get(), windowWidth, windowHeight);
 #ifdef _WIN32
-                                    setWindowShadow(hwnd, {0, 0, 0, 0});
+                            setWindowShadow(hwnd, {0, 0, 0, 0});
 #endif
-                                    scenePtr->setScene("Settings-Themes");
-                                }
+                            scenePtr->setScene(Scenes::SettingsThemes);
+                        }
 
-                                if (button == themesExitBtn) {
-                                    // close anything still opened
-                                    if (setBGIsPressed)
-                                        setBGIsPressed = false;
+                        if (button == themesExitBtn) {
+                            // close anything still opened
+                            if (setBGIsPressed)
+                                setBGIsPressed = false;
 
-                                    if (setTypographyIsPressed)
-                                        setTypographyIsPressed = false;
+                            if (setTypographyIsPressed)
+                                setTypographyIsPressed = false;
 
-                                    scenePtr->setScene("Settings");
-                                }
-                            }
+                            scenePtr->setScene(Scenes::Settings);
                         }
                     }
+
+                    // read the colour straight from the generated picker pixels
+                    if (scenePtr->getCurrentScene() == Scenes::ThemeCreator &&
+                        interfacePtr->cursorInBounds(colorPickerBounds, interfacePtr->getMousePos())) {
+                        const SDL_Point &mousePos = interfacePtr->getMousePos();
+                        pickedColor = colorPickerPtr->pick(mousePos.x, mousePos.y);
+                        interfacePtr->getButtonText(buttonColorInputBtn) =
+                            std::format("#{:02X}{:02X}{:02X}", pickedColor.r, pickedColor.g, pickedColor.b);
+                    }
+                } break;
+
+                case SDL_KEYUP: {
+                    keyMods = ev.key.keysym.mod;
                 } break;
 
                 case SDL_KEYDOWN: {
+                    keyMods = ev.key.keysym.mod;
                     switch (ev.key.keysym.sym) {
                         case SDLK_RETURN: {
                             if (setBGIsPressed) {
-                                auto &bgColorText = bgColorInputBtn->text;
+                                auto &bgColorText = interfacePtr->getButtonText(bgColorInputBtn);
                                 // apply the colour to the background and reset the text
                                 if (bgColorText.contains(',')) {
                                     // check if a character is alphabetical
@@ -426,7 +544,11 @@ namespace Application {
                                 } else if (bgColorText.contains('#')) {
                                     const char *hexVal = bgColorText.c_str();
                                     // convert the hex to rgb
-                                    sscanf_s(hexVal, "#%02x%02x%02x", &redViewColor, &greenViewColor, &blueViewColor);
+                                    unsigned int red = 0, green = 0, blue = 0;
+                                    std::sscanf(hexVal, "#%02x%02x%02x", &red, &green, &blue);
+                                    redViewColor = static_cast<int>(red);
+                                    greenViewColor = static_cast<int>(green);
+                                    blueViewColor = static_cast<int>(blue);
                                 } else if (!bgColorText.contains(',')) {
                                     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Background Color Error",
                                                              "String input does not contain commas!", window.get());
@@ -436,73 +558,83 @@ namespace Application {
 
                             if (setTypographyIsPressed) {
                                 // check path given
-                                if (!typographyInputBtn->text.contains(".ttf")) {
+                                if (!interfacePtr->getButtonText(typographyInputBtn).contains(".ttf")) {
                                     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Typography Error",
                                                              "Font file not found!", window.get());
-                                    typographyInputBtn->text = "Set Font";
+                                    interfacePtr->getButtonText(typographyInputBtn) = "Set Font";
                                 } else {
-                                    typographyStr = dirPath + "assets/" + typographyInputBtn->text;
-                                    typographyInputBtn->text = "Set Font";
+                                    typographyStr =
+                                        dirPath + "assets/" + interfacePtr->getButtonText(typographyInputBtn);
+                                    ++typographyVersion;
+                                    interfacePtr->getButtonText(typographyInputBtn) = "Set Font";
                                 }
                             }
                         } break;
 
+                        case SDLK_F3: {
+                            profiler.setEnabled(!profiler.isEnabled());
+                        } break;
+
+                        case SDLK_F4: {
+                            requestMemoryDump(0);
+                        } break;
+
                         case SDLK_c: {
                             if (setBGIsPressed) {
-                                if (SDL_GetModState() & KMOD_CTRL)
-                                    SDL_SetClipboardText(bgColorInputBtn->text.c_str());
+                                if (keyMods & KMOD_CTRL)
+                                    SDL_SetClipboardText(interfacePtr->getButtonText(bgColorInputBtn).c_str());
 
                             } else if (setTypographyIsPressed) {
-                                if (SDL_GetModState() & KMOD_CTRL)
-                                    SDL_SetClipboardText(typographyInputBtn->text.c_str());
+                                if (keyMods & KMOD_CTRL)
+                                    SDL_SetClipboardText(interfacePtr->getButtonText(typographyInputBtn).c_str());
                             }
                         } break;
 
                         case SDLK_v: {
                             if (setBGIsPressed) {
-                                if (SDL_GetModState() & KMOD_CTRL)
-                                    bgColorInputBtn->text = SDL_GetClipboardText();
+                                if (keyMods & KMOD_CTRL)
+                                    interfacePtr->getButtonText(bgColorInputBtn) = SDL_GetClipboardText();
 
                             } else if (setTypographyIsPressed) {
-                                if (SDL_GetModState() & KMOD_CTRL)
-                                    typographyInputBtn->text = SDL_GetClipboardText();
+                                if (keyMods & KMOD_CTRL)
+                                    interfacePtr->getButtonText(typographyInputBtn) = SDL_GetClipboardText();
                             }
                         } break;
 
                         case SDLK_BACKSPACE: {
                             if (setBGIsPressed) {
-                                if (bgColorInputBtn->text.contains("Set Color"))
+                                if (interfacePtr->getButtonText(bgColorInputBtn).contains("Set Color"))
                                     break;
 
-                                if (bgColorInputBtn->text.length() > 0)
-                                    bgColorInputBtn->text.pop_back();
+                                if (interfacePtr->getButtonText(bgColorInputBtn).length() > 0)
+                                    interfacePtr->getButtonText(bgColorInputBtn).pop_back();
 
                             } else if (setTypographyIsPressed) {
-                                if (typographyInputBtn->text.contains("Set Font"))
+                                if (interfacePtr->getButtonText(typographyInputBtn).contains("Set Font"))
                                     break;
 
-                                if (typographyInputBtn->text.length() > 0)
-                                    typographyInputBtn->text.pop_back();
+                                if (interfacePtr->getButtonText(typographyInputBtn).length() > 0)
+                                    interfacePtr->getButtonText(typographyInputBtn).pop_back();
                             }
                         } break;
                     }
                 } break;
 
                 case SDL_TEXTINPUT: {
-                    if (!(SDL_GetModState() & KMOD_CTRL && (ev.text.text[0] == 'c' || ev.text.text[0] == 'C' ||
+                    if (!(keyMods & KMOD_CTRL && (ev.text.text[0] == 'c' || ev.text.text[0] == 'C' ||
                                                             ev.text.text[0] == 'v' || ev.text.text[0] == 'V'))) {
-                        if (setBGIsPressed && bgColorInputBtn->isEnabled) {
-                            if (bgColorInputBtn->text.contains("Set Color"))
+                        if (setBGIsPressed && interfacePtr->hasFlag(bgColorInputBtn, Helper::ButtonEnabled)) {
+                            if (interfacePtr->getButtonText(bgColorInputBtn).contains("Set Color"))
                                 break;
 
-                            bgColorInputBtn->text += ev.text.text;
+                            interfacePtr->getButtonText(bgColorInputBtn) += ev.text.text;
                         }
 
-                        if (setTypographyIsPressed && setTypographyBtn->isEnabled) {
-                            if (typographyInputBtn->text.contains("Set Font"))
+                        if (setTypographyIsPressed && interfacePtr->hasFlag(setTypographyBtn, Helper::ButtonEnabled)) {
+                            if (interfacePtr->getButtonText(typographyInputBtn).contains("Set Font"))
                                 break;
 
-                            typographyInputBtn->text += ev.text.text;
+                            interfacePtr->getButtonText(typographyInputBtn) += ev.text.text;
                         }
                     }
                 } break;
@@ -517,6 +649,10 @@ namespace Application {
                     }
 
                     if (interfacePtr->cursorInBounds(colorSliderBounds, interfacePtr->getMousePos())) {
+                        // the square is only generated again when the hue changes
+                        if (scenePtr->getCurrentScene() == Scenes::ThemeCreator)
+                            colorPickerPtr->setHueAt(ev.motion.y);
+
                         // move slider base by 5px
                         // center
                         themesSlider[0].position.y = static_cast<float>(ev.motion.y);
@@ -540,251 +676,410 @@ namespace Application {
             end = std::chrono::steady_clock::now();
             deltaTime = (double)std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
             begin = end;
-
-            // disable buttons that are not on the current layer being displayed
-            for (const auto &button : interfacePtr->getButtonList()) {
-                if (button->layer == scenePtr->getCurrentSceneName()) {
-                    button->isEnabled = true;
-                } else {
-                    button->isEnabled = false;
-                }
-            }
-
-            imagePtr->getAnimPtr()->update(37, deltaTime);
+            // a replayed frame always stands for one frame of time
+            if (replay.isReplaying())
+                deltaTime = delay;
+            profiler.lap(Helper::Phase::Events);
+
+            if (!power.isVisible() && !replay.isReplaying())
+                continue;
+
+            // the gif is frozen under the settings menus, so their blurred backdrop stays valid
+            if (scenePtr->getCurrentScene() == Scenes::Main)
+                imagePtr->getAnimPtr()->update(37, deltaTime);
+            profiler.lap(Helper::Phase::Animation);
             interfacePtr->update(&ev, deltaTime);
+            transitionPtr->update(deltaTime);
+            profiler.lap(Helper::Phase::Interface);
 
             draw();
+            // the scenes that may follow are loaded after this one was shown
+            scenePtr->update(std::chrono::steady_clock::now());
+
+            memoryReport.sample(scenePtr->getCurrentScene(), imagePtr->getTextureBytes() + imagePtr->getLayerBytes());
+            if (memoryDumpRequested != 0) {
+                memoryDumpRequested = 0;
+                std::cout << memoryReport.toJson(*imagePtr, sceneNames);
+            }
+
+            if (replay.isReplaying()) {
+                replay.endFrame(deltaTime, std::chrono::duration<double, std::milli>(
+                                               std::chrono::steady_clock::now() - frameStart)
+                                               .count());
+                if (replay.isDone()) {
+                    replay.report(options.reportFile);
+                    shouldRun = false;
+                }
+            }
         }
         free();
     }
 
     // usually you want this to be independent
     void Anya::draw() {
+        Helper::TraceScope scope("draw");
         SDL_SetRenderDrawBlendMode(renderer.get(), SDL_BLENDMODE_BLEND);
         SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255);
         SDL_RenderClear(renderer.get());
 
-        if (scenePtr->getCurrentScene() == scenePtr->findScene("Main")) {
-            timeText = imagePtr->createTextA(
-                {timeToStr(std::chrono::system_clock::now()), typographyStr, {{0}, {0}, {255, 255, 255}}, 28},
-                renderer.get());
-            dateText = imagePtr->createTextA(
-                {std::format("{:%Ex}", std::chrono::current_zone()->to_local(std::chrono::system_clock::now())),
-                 dirPath + "assets/Onest.ttf",
-                 {{0}, {0}, {255, 255, 255}},
-                 16},
-                renderer.get());
-            settingsText = imagePtr->createText(
-                {settingsBtn->text, dirPath + "assets/Onest.ttf", settingsBtn->buttonColor, 96}, renderer.get());
-
-            if (setBGToColor) {
-                SDL_SetRenderDrawColor(renderer.get(), redViewColor, greenViewColor, blueViewColor, 255);
-                SDL_RenderFillRect(renderer.get(), &fillBGColor);
-            } else if (setBGtoImg) {
-                imagePtr->draw(backgroundImg, renderer.get(), 0, 0);
-            } else {
-                imagePtr->drawAnimation(backgroundGIF, renderer.get(), 0, 0);
-            }
+        // a running transition only blends its two snapshots
+        if (transitionPtr->isActive()) {
+            profiler.lap(Helper::Phase::Draw);
+            transitionPtr->draw(renderer.get());
+        } else {
+            drawScene(scenePtr->getCurrentScene());
+        }
+        profiler.lap(Helper::Phase::Draw);
 
-            if (showDate)
-                imagePtr->draw(dateText, renderer.get(), static_cast<int>(windowWidth / 4),
-                               static_cast<int>(windowHeight / 2.1));
+        profiler.draw(renderer.get(), *imagePtr, dirPath + "assets/Onest.ttf");
+        profiler.lap(Helper::Phase::Overlay);
 
-            imagePtr->draw(timeText, renderer.get(), static_cast<int>((windowWidth - timeText->imageWidth) / 2),
-                           (windowHeight - timeText->imageHeight) + 2);
+        if (replay.isLastFrame())
+            replay.setChecksum(Helper::Replay::checksum(renderer.get()));
 
-            interfacePtr->setButtonTextSize(settingsText, 1, 16);
-            interfacePtr->draw(settingsBtn, settingsText, renderer.get());
+        // the inputs handled this frame show up with this present
+        const int64_t presentStart = Helper::traceNow();
+        {
+            Helper::TraceScope present("present");
+            SDL_RenderPresent(renderer.get());
         }
+        Helper::tracePresent(presentStart);
+        profiler.lap(Helper::Phase::Present);
+
+        // lower while unfocused or saving power
+        const double frameDelay = power.getFrameDelay(delay);
+        if (!replay.isReplaying() && deltaTime < frameDelay)
+            SDL_Delay(static_cast<uint32_t>(frameDelay - deltaTime));
+        profiler.lap(Helper::Phase::Sleep);
+        profiler.endFrame();
+    }
 
-        if (scenePtr->getCurrentScene() == scenePtr->findScene("Minimal-Main")) {
-            timeText = imagePtr->createTextA(
-                {timeToStr(std::chrono::system_clock::now()), typographyStr, {{0}, {0}, {255, 255, 255}}, 28},
-                renderer.get());
+    bool Anya::isAnimating() {
+        // the gif background is the only thing that moves by itself (and the profiler graph when it is shown)
+        return (scenePtr->getCurrentScene() == Scenes::Main && !setBGToColor && !setBGtoImg) || profiler.isEnabled();
+    }
 
-            mainQuitText = imagePtr->createText(
-                {mainQuitBtn->text, dirPath + "assets/Onest.ttf", mainQuitBtn->buttonColor, 96}, renderer.get());
+    int Anya::idleTimeout() {
+        const auto now = std::chrono::system_clock::now();
+        const auto nextMinute = std::chrono::floor<std::chrono::minutes>(now) + std::chrono::minutes(1);
+        const int timeout =
+            static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(nextMinute - now).count()) + 1;
+        // zones with an offset of seconds (or a transition) tick off the local minute
+        const int clockTimeout = worldClockPtr->getTimeout(now);
 
-            minimizeText = imagePtr->createText(
-                {minimizeBtn->text, dirPath + "assets/Onest.ttf", minimizeBtn->buttonColor, 96}, renderer.get());
+        return (clockTimeout < 0) ? timeout : std::min(timeout, clockTimeout);
+    }
 
-            SDL_SetRenderDrawColor(renderer.get(), redViewColor, greenViewColor, blueViewColor, 255);
-            SDL_RenderFillRect(renderer.get(), &fillBGColor);
+    void Anya::drawScene(Helper::SceneID scene) {
+        // the picker & slider of the theme creator are only drawn through the renderer
+        Helper::Compositor *target = nullptr;
+        if (compositing && scene != Scenes::ThemeCreator) {
+            int w = 0;
+            int h = 0;
+            SDL_GetRendererOutputSize(renderer.get(), &w, &h);
+            const SDL_Point size = sceneFrame.getSize();
+            if ((size.x == w && size.y == h) || sceneFrame.create(renderer.get(), w, h) == 0)
+                target = &sceneFrame;
+        }
 
-            imagePtr->draw(timeText, renderer.get(), static_cast<int>((minWindowWidth - timeText->imageWidth) / 2),
-                           (minWindowHeight - timeText->imageHeight) + 2);
+        if (target != nullptr)
+            target->clear({0, 0, 0, 255});
+        setDrawTarget(target);
 
-            interfacePtr->setButtonTextSize(mainQuitText, -2, 0);
-            interfacePtr->draw(mainQuitBtn, mainQuitText, renderer.get());
-            interfacePtr->draw(minimizeBtn, minimizeText, renderer.get());
-            interfacePtr->draw(returnBtn, nullptr, renderer.get());
+        if (scene == Scenes::Main) {
+            profiler.lap(Helper::Phase::Draw);
+            drawMainBackground();
+            interfacePtr->draw(settingsBtn, renderer.get());
         }
 
-        if (scenePtr->getCurrentScene() == scenePtr->findScene("Settings")) {
-            settingsExitText = imagePtr->createText(
-                {settingsExitBtn->text, dirPath + "assets/Onest.ttf", settingsExitBtn->buttonColor, 72},
-                renderer.get());
-            themesText = imagePtr->createText(
-                {themesBtn->text, dirPath + "assets/Onest.ttf", themesBtn->buttonColor, 32}, renderer.get());
-            quitText = imagePtr->createText(
-                {settingsQuitBtn->text, dirPath + "assets/Onest.ttf", settingsQuitBtn->buttonColor, 96},
-                renderer.get());
-            // brown background colour
-            SDL_SetRenderDrawColor(renderer.get(), 26, 17, 16, 255);
-            SDL_RenderFillRect(renderer.get(), &settingsView);
-
-            interfacePtr->draw(settingsExitBtn, settingsExitText, renderer.get());
-            interfacePtr->draw(settingsQuitBtn, quitText, renderer.get());
-            interfacePtr->draw(githubBtn, nullptr, renderer.get());
-            interfacePtr->draw(themesBtn, themesText, renderer.get());
-            interfacePtr->draw(calendarBtn, nullptr, renderer.get());
+        if (scene == Scenes::MinimalMain) {
+            profiler.lap(Helper::Phase::Draw);
+            timeText = imagePtr->createTextA(
+                {timeToStr(replay.now()), typographyStr, {{0}, {0}, {255, 255, 255}}, 28},
+                renderer.get(), timeText);
+            profiler.lap(Helper::Phase::Text);
+
+            fillRect(fillBGColor, {static_cast<uint8_t>(redViewColor), static_cast<uint8_t>(greenViewColor),
+                                   static_cast<uint8_t>(blueViewColor), 255});
+
+            const SDL_Point timeSize = imagePtr->getSize(timeText);
+            imagePtr->draw(timeText, renderer.get(), static_cast<int>((minWindowWidth - timeSize.x) / 2),
+                           (minWindowHeight - timeSize.y) + 2);
+
+            interfacePtr->draw(mainQuitBtn, renderer.get());
+            interfacePtr->draw(minimizeBtn, renderer.get());
+            interfacePtr->draw(returnBtn, renderer.get());
         }
 
-        if (scenePtr->getCurrentScene() == scenePtr->findScene("Settings-Themes")) {
-            themesExitText = imagePtr->createText(
-                {themesExitBtn->text, dirPath + "assets/Onest.ttf", themesExitBtn->buttonColor, 96}, renderer.get());
-            minimalText = imagePtr->createText(
-                {minimalBtn->text, dirPath + "assets/Onest.ttf", minimalBtn->buttonColor, 96}, renderer.get());
-            setBGText = imagePtr->createText({setBGBtn->text, dirPath + "assets/Onest.ttf", setBGBtn->buttonColor, 96},
-                                             renderer.get());
-            // brown background colour
-            SDL_SetRenderDrawColor(renderer.get(), 26, 17, 16, 255);
-            SDL_RenderFillRect(renderer.get(), &settingsThemesView);
-
-            interfacePtr->draw(themesExitBtn, themesExitText, renderer.get());
-            interfacePtr->draw(minimalBtn, minimalText, renderer.get());
-            interfacePtr->draw(setBGBtn, setBGText, renderer.get());
-            interfacePtr->draw(setTypographyBtn, nullptr, renderer.get());
-            interfacePtr->draw(setThemeBtn, nullptr, renderer.get());
+        if (scene == Scenes::Settings) {
+            // the main scene blurred & tinted with the menu colour (brown by default)
+            drawBackdrop(settingsView);
 
-            if (setTypographyIsPressed) {
-                typographyInputText = imagePtr->createText(
-                    {typographyInputBtn->text, dirPath + "assets/Onest.ttf", openFileBtn->buttonColor, 96},
-                    renderer.get());
+            interfacePtr->draw(settingsExitBtn, renderer.get());
+            interfacePtr->draw(settingsQuitBtn, renderer.get());
+            interfacePtr->draw(githubBtn, renderer.get());
+            interfacePtr->draw(themesBtn, renderer.get());
+            interfacePtr->draw(calendarBtn, renderer.get());
+        }
+
+        if (scene == Scenes::SettingsThemes) {
+            drawBackdrop(settingsThemesView);
 
-                interfacePtr->setButtonTextSize(typographyInputText, -45, 2);
-                interfacePtr->draw(typographyInputBtn, typographyInputText, renderer.get());
+            interfacePtr->draw(themesExitBtn, renderer.get());
+            interfacePtr->draw(minimalBtn, renderer.get());
+            interfacePtr->draw(setBGBtn, renderer.get());
+            interfacePtr->draw(setTypographyBtn, renderer.get());
+            interfacePtr->draw(setThemeBtn, renderer.get());
+
+            if (setTypographyIsPressed) {
+                interfacePtr->draw(typographyInputBtn, renderer.get());
             }
 
             if (setBGIsPressed) {
-                openFileText = imagePtr->createText(
-                    {openFileBtn->text, dirPath + "assets/Onest.ttf", openFileBtn->buttonColor, 96}, renderer.get());
-                bgColorInputText = imagePtr->createText(
-                    {bgColorInputBtn->text, dirPath + "assets/Onest.ttf", bgColorInputBtn->buttonColor, 28},
-                    renderer.get());
-
-                interfacePtr->draw(openFileBtn, openFileText, renderer.get());
-                interfacePtr->draw(bgColorInputBtn, bgColorInputText, renderer.get());
+                interfacePtr->draw(openFileBtn, renderer.get());
+                interfacePtr->draw(bgColorInputBtn, renderer.get());
             }
         }
 
-        if (scenePtr->getCurrentScene() == scenePtr->findScene("Theme-Creator")) {
-            exitThemeCreatorText = imagePtr->createText(
-                {exitThemeCreatorBtn->text, dirPath + "assets/Onest.ttf", exitThemeCreatorBtn->buttonColor, 96},
-                renderer.get());
-            themesMenuBGText = imagePtr->createText(
-                {setMenuBGBtn->text, dirPath + "assets/Onest.ttf", setMenuBGBtn->buttonColor, 96}, renderer.get());
-            themesBGCText = imagePtr->createText(
-                {setButtonBGCBtn->text, dirPath + "assets/Onest.ttf", setButtonBGCBtn->buttonColor, 32},
-                renderer.get());
-            themesOCText = imagePtr->createText(
-                {setButtonOCBtn->text, dirPath + "assets/Onest.ttf", setButtonOCBtn->buttonColor, 96}, renderer.get());
-            themesTCText = imagePtr->createText(
-                {setButtonTCBtn->text, dirPath + "assets/Onest.ttf", setButtonTCBtn->buttonColor, 96}, renderer.get());
-            buttonColorInputText = imagePtr->createText(
-                {buttonColorInputBtn->text, dirPath + "assets/Onest.ttf", buttonColorInputBtn->buttonColor, 100},
-                renderer.get());
-
+        if (scene == Scenes::ThemeCreator) {
             SDL_Rect paintingScreen = {0, 0, (int)windowWidth, (int)windowHeight};
-            SDL_SetRenderDrawColor(renderer.get(), 26, 17, 16, 255);
+            SDL_SetRenderDrawColor(renderer.get(), menuColor.r, menuColor.g, menuColor.b, 255);
             SDL_RenderFillRect(renderer.get(), &paintingScreen);
 
-            interfacePtr->draw(exitThemeCreatorBtn, exitThemeCreatorText, renderer.get());
+            interfacePtr->draw(exitThemeCreatorBtn, renderer.get());
             // menu background colour
-            interfacePtr->setButtonTextSize(themesMenuBGText, 0, 5);
-            interfacePtr->draw(setMenuBGBtn, themesMenuBGText, renderer.get());
+            interfacePtr->draw(setMenuBGBtn, renderer.get());
             // button background colour
-            interfacePtr->setButtonTextSize(themesBGCText, -15, 5);
-            interfacePtr->draw(setButtonBGCBtn, themesBGCText, renderer.get());
+            interfacePtr->draw(setButtonBGCBtn, renderer.get());
             // button outline colour
-            interfacePtr->setButtonTextSize(themesOCText, -10, 5);
-            interfacePtr->draw(setButtonOCBtn, themesOCText, renderer.get());
+            interfacePtr->draw(setButtonOCBtn, renderer.get());
             // button text colour
-            interfacePtr->setButtonTextSize(themesTCText, -15, 5);
-            interfacePtr->draw(setButtonTCBtn, themesTCText, renderer.get());
-
-            // draw a quad
-            SDL_Vertex colorPicker[4] = {0};
-            // bottom left
-            colorPicker[0].position.x = static_cast<float>((windowWidth / 2) + 9);
-            colorPicker[0].position.y = static_cast<float>(windowWidth / 2);
-            colorPicker[0].color = {0, 0, 0, 255};
-            // top left
-            colorPicker[1].position.x = static_cast<float>((windowWidth / 2) + 9);
-            colorPicker[1].position.y = 0;
-            colorPicker[1].color = {255, 255, 255, 255};
-            // top right
-            colorPicker[2].position.x = static_cast<float>((windowWidth / 2) + 80);
-            colorPicker[2].position.y = 0;
-            colorPicker[2].color = {255, 0, 0, 255};
-            // bottom right
-            colorPicker[3].position.x = static_cast<float>((windowWidth / 2) + 80);
-            colorPicker[3].position.y = static_cast<float>(windowWidth / 2);
-            colorPicker[3].color = {0, 0, 0, 255};
-
-            constexpr int colorPickerIndices[] = {0, 1, 2, 0, 2, 3};
-
-            // clang-format off
-            static SDL_Color colours[7] = {
-                {255, 0, 0, 255}, 
-                {255, 255, 0, 255}, 
-                {0, 255, 0, 255}, 
-                {0, 255, 255, 255},
-                {0, 0, 255, 255}, 
-                {255, 0, 255, 255}, 
-                {255, 0, 0, 255}
-            };
-
-            for (int i = 0; i < 6; ++i) {
-                const SDL_FRect colorSlider = {
-                    static_cast<float>(windowWidth / 2),
-                    static_cast<float>(i * (15)),
-                    static_cast<float>((windowWidth / 2) + 8),
-                    static_cast<float>((i + 1) * 15)
-                };
-
-                interfacePtr->drawGradient(colorSlider, colours[i], colours[i + 1], renderer.get());
-            }
-            // clang-format on
+            interfacePtr->draw(setButtonTCBtn, renderer.get());
+
+            // saturation/value square & hue strip
+            colorPickerPtr->draw(renderer.get());
 
             interfacePtr->drawDivider({static_cast<int>(windowWidth / 2), 0, 1, static_cast<int>(windowHeight)},
                                       {240, 209, 189, 255}, renderer.get());
             interfacePtr->drawDivider({static_cast<int>((windowWidth / 2) + 8), 0, 1, static_cast<int>(windowHeight)},
                                       {240, 209, 189, 255}, renderer.get());
 
+            // the slider & highlight are drawn over the dividers
+            interfacePtr->flush(renderer.get());
+
             SDL_RenderGeometry(renderer.get(), nullptr, themesSliderOutline, 3, nullptr, 0);
             SDL_RenderGeometry(renderer.get(), nullptr, themesSlider, 3, nullptr, 0);
-            SDL_RenderGeometry(renderer.get(), nullptr, colorPicker, 4, colorPickerIndices, 6);
 
             if (inColorPickerBounds) {
                 SDL_SetRenderDrawColor(renderer.get(), 255, 255, 255, 255);
                 SDL_RenderDrawRect(renderer.get(), &themesColorPicker);
             }
 
-            interfacePtr->setButtonTextSize(buttonColorInputText, -30, 5);
-            interfacePtr->draw(buttonColorInputBtn, buttonColorInputText, renderer.get());
+            interfacePtr->draw(buttonColorInputBtn, renderer.get());
+        }
+
+        interfacePtr->flush(renderer.get());
+
+        // one upload & copy for everything the scene drew
+        if (target != nullptr) {
+            target->present(renderer.get());
+            setDrawTarget(nullptr);
+        }
+    }
+
+    void Anya::setDrawTarget(Helper::Compositor *target) {
+        imagePtr->setDrawTarget(target);
+        interfacePtr->getBatch().setDrawTarget(target);
+        worldClockPtr->getBatch().setDrawTarget(target);
+    }
+
+    void Anya::fillRect(const SDL_Rect &rect, const SDL_Color &col) {
+        if (Helper::Compositor *target = imagePtr->getDrawTarget(); target != nullptr) {
+            target->fillRect(rect, col);
+            return;
+        }
+
+        SDL_SetRenderDrawColor(renderer.get(), col.r, col.g, col.b, col.a);
+        SDL_RenderFillRect(renderer.get(), &rect);
+    }
+
+    void Anya::drawMainBackground() {
+        timeText = imagePtr->createTextA({timeToStr(replay.now()), typographyStr, {{0}, {0}, {255, 255, 255}}, 28},
+                                         renderer.get(), timeText);
+        dateText = imagePtr->createTextA({std::format("{:%Ex}", std::chrono::current_zone()->to_local(replay.now())),
+                                          dirPath + "assets/Onest.ttf",
+                                          {{0}, {0}, {255, 255, 255}},
+                                          16},
+                                         renderer.get(), dateText);
+        profiler.lap(Helper::Phase::Text);
+
+        if (setBGToColor) {
+            fillRect(fillBGColor, {static_cast<uint8_t>(redViewColor), static_cast<uint8_t>(greenViewColor),
+                                   static_cast<uint8_t>(blueViewColor), 255});
+        } else if (setBGtoImg) {
+            imagePtr->draw(backgroundImg, renderer.get(), 0, 0);
+        } else {
+            imagePtr->drawAnimation(backgroundGIF, renderer.get(), 0, 0);
+        }
+
+        if (showDate)
+            imagePtr->draw(dateText, renderer.get(), static_cast<int>(windowWidth / 4),
+                           static_cast<int>(windowHeight / 2.1));
+
+        const SDL_Point timeSize = imagePtr->getSize(timeText);
+        imagePtr->draw(timeText, renderer.get(), static_cast<int>((windowWidth - timeSize.x) / 2),
+                       (windowHeight - timeSize.y) + 2);
+
+        worldClockPtr->update(replay.now());
+        worldClockPtr->draw(renderer.get(), 3, 2);
+    }
+
+    void Anya::refreshBackdrop() {
+        // everything the main scene shows, read every frame so only plain values go into the key (the clock & date
+        // change with the minute, the clocks bump their version)
+        const auto minute = std::chrono::floor<std::chrono::minutes>(replay.now()).time_since_epoch().count();
+        const int frame = imagePtr->getAnimPtr()->getFrame();
+        const bool flags[3] {setBGToColor, setBGtoImg, showDate};
+        const int bgColor[3] {redViewColor, greenViewColor, blueViewColor};
+        // a gif that is loaded again comes back under a new handle, one that is missing has to be drawn once it is
+        const bool gifLoaded = imagePtr->getSize(backgroundGIF).x != 0;
+        const uint64_t clocksVersion = worldClockPtr->getVersion();
+        uint64_t key = fnv1a(&minute, sizeof(minute));
+        key = fnv1a(&typographyVersion, sizeof(typographyVersion), key);
+        key = fnv1a(flags, sizeof(flags), key);
+        key = fnv1a(bgColor, sizeof(bgColor), key);
+        key = fnv1a(&backgroundImg.id, sizeof(backgroundImg.id), key);
+        key = fnv1a(&backgroundGIF.id, sizeof(backgroundGIF.id), key);
+        key = fnv1a(&gifLoaded, sizeof(gifLoaded), key);
+        key = fnv1a(&frame, sizeof(frame), key);
+        key = fnv1a(&menuColor, sizeof(menuColor), key);
+        if (fnv1a(&clocksVersion, sizeof(clocksVersion), key) == backdropKey)
+            return;
+
+        // the menus draw main under themselves, its gif may have been released while another scene was shown
+        if (!setBGToColor && !setBGtoImg)
+            scenePtr->load(Scenes::Main);
+
+        // composited, the main scene is drawn into the frame on the cpu & nothing has to be read back
+        Helper::Compositor *target = imagePtr->getDrawTarget();
+        const SDL_Point size = (target != nullptr)
+                                   ? target->getSize()
+                                   : SDL_Point {static_cast<int>(windowWidth), static_cast<int>(windowHeight)};
+        const int w = size.x;
+        const int h = size.y;
+        if (target == nullptr && !backdropTarget) {
+            backdropTarget = imagePtr->createRenderTarget(renderer.get(), windowWidth, windowHeight);
+            if (!backdropTarget)
+                return;
+        }
+
+        const SDL_Point backdropSize = backdrop.getSize();
+        if ((backdropSize.x != w || backdropSize.y != h) && backdrop.create(renderer.get(), w, h) != 0)
+            return;
+
+        backdropLayer.w = w;
+        backdropLayer.h = h;
+        backdropLayer.pixels.resize(static_cast<size_t>(w) * h);
+        if (target != nullptr) {
+            target->clear({0, 0, 0, 255});
+            drawMainBackground();
+            std::copy_n(target->getPixels(), backdropLayer.pixels.size(), backdropLayer.pixels.begin());
+        } else {
+            // the snapshot is read back once, blurred on the cpu & cached in the compositor's texture
+            // a transition may be snapshotting the menu into a target of its own
+            SDL_Texture *previousTarget = SDL_GetRenderTarget(renderer.get());
+            SDL_SetRenderTarget(renderer.get(), imagePtr->getTexture(backdropTarget, renderer.get()));
+            SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255);
+            SDL_RenderClear(renderer.get());
+            drawMainBackground();
+            const int read = SDL_RenderReadPixels(renderer.get(), nullptr, SDL_PIXELFORMAT_ARGB8888,
+                                                  backdropLayer.pixels.data(), w * 4);
+            SDL_SetRenderTarget(renderer.get(), previousTarget);
+            if (read != 0) {
+                panicln("Failed to read the backdrop");
+                return;
+            }
+        }
+        // drawing main lays the clocks out for the new minute, the key takes the version they have now
+        const uint64_t drawnVersion = worldClockPtr->getVersion();
+        backdropKey = fnv1a(&drawnVersion, sizeof(drawnVersion), key);
+
+        // blurred & dimmed once, a menu frame only copies the result
+        Helper::boxBlur(backdropLayer.pixels.data(), w, h, 4);
+        backdrop.copy(backdropLayer, 0, 0);
+        backdrop.fillRect({0, 0, w, h}, {menuColor.r, menuColor.g, menuColor.b, backdropDim});
+        if (target != nullptr) {
+            std::copy_n(backdrop.getPixels(), backdropLayer.pixels.size(), backdropLayer.pixels.begin());
+            backdropLayer.opaque = true;
+        }
+    }
+
+    void Anya::drawBackdrop(const SDL_Rect &view) {
+        refreshBackdrop();
+
+        // the composited frame copies the dimmed pixels, the renderer copies the cached texture
+        if (Helper::Compositor *target = imagePtr->getDrawTarget(); target != nullptr) {
+            target->copy(backdropLayer, view.x, view.y);
+            return;
         }
 
-        SDL_RenderPresent(renderer.get());
+        backdrop.present(renderer.get(), &view);
+    }
+
+    void Anya::startTransition(Helper::SceneID previous, Helper::SceneID current) {
+        // how deep a scene is in the menus, going deeper slides left & coming back slides right
+        const auto depth = [](Helper::SceneID scene) {
+            switch (scene) {
+                case Scenes::Main:
+                    return 0;
+                case Scenes::Settings:
+                    return 1;
+                case Scenes::SettingsThemes:
+                    return 2;
+                case Scenes::ThemeCreator:
+                    return 3;
+                default:
+                    return -1;
+            }
+        };
+
+        const int from = depth(previous);
+        const int to = depth(current);
+        Helper::TransitionStyle style = Helper::TransitionStyle::SlideLeft;
+        if (from < 0 || to < 0)
+            style = Helper::TransitionStyle::Cut;
+        else if (from + to == 1)
+            style = Helper::TransitionStyle::Fade;
+        else if (to < from)
+            style = Helper::TransitionStyle::SlideRight;
+
+        transitionPtr->start(
+            renderer.get(), static_cast<int>(windowWidth), static_cast<int>(windowHeight), style, 220.0,
+            [this, previous] { drawScene(previous); }, [this, current] { drawScene(current); });
+    }
+
+    int Anya::loadBackgroundGIF() {
+        // the pack is a render target, it is built again after a release instead of reloaded
+        if (imagePtr->getSize(backgroundGIF).x == 0)
+            backgroundGIF = imagePtr->createPack("canvas", dirPath + "assets/gif-extract/", renderer.get());
 
-        if (deltaTime < delay)
-            SDL_Delay(static_cast<uint32_t>(delay - deltaTime));
+        return backgroundGIF ? 0 : -1;
+    }
+
+    Helper::SceneManifest Anya::imageManifest(std::vector<Helper::ImageHandle> images,
+                                              std::vector<Helper::SceneID> next) {
+        return {[this, images] { return imagePtr->loadImages(images, renderer.get()); },
+                [this, images] { imagePtr->releaseImages(images); }, std::move(next)};
     }
 
     void Anya::free() {
         std::cout << "releasing allocated resources..\n";
+        Helper::traceStop();
         SDL_StopTextInput();
         NFD_Quit();
+        // fonts have to be closed before SDL_ttf shuts down
+        if (imagePtr)
+            imagePtr->clearFonts();
         TTF_Quit();
         IMG_Quit();
         SDL_Quit();
@@ -794,7 +1089,11 @@ namespace Application {
         // convert time_point to a useable hour
         struct tm localTime;
         time_t currentTime = std::chrono::system_clock::to_time_t(time);
+#ifdef _WIN32
         localtime_s(&localTime, &currentTime);
+#else
+        localtime_r(&currentTime, &localTime);
+#endif
 
         auto hour = std::chrono::hours(localTime.tm_hour);
 
@@ -5,8 +5,19 @@
 #include "uinterface.hpp"
 #include "util.hpp"
 #include "scene.hpp"
+#include "colorpicker.hpp"
+#include "compositor.hpp"
+#include "memory.hpp"
+#include "power.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "trace.hpp"
+#include "transition.hpp"
+#include "worldclock.hpp"
+#include <array>
 #include <chrono>
 #include <format>
+#include <vector>
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN
     #include <dwmapi.h>
@@ -20,16 +31,71 @@
 namespace Application {
     using namespace Helper::Utils;
 
+    // scene IDs, every scene in sceneNames is created at boot
+    namespace Scenes {
+        enum : Helper::SceneID { Main, MinimalMain, Settings, SettingsThemes, ThemeCreator, Count };
+    } // namespace Scenes
+
+    inline constexpr std::array<std::string_view, Scenes::Count> sceneNames {
+        "Main", "Minimal-Main", "Settings", "Settings-Themes", "Theme-Creator"};
+
+    // command line options (main.cpp)
+    struct LaunchOptions final {
+        // record the session's events to this file (--record)
+        std::basic_string<char> recordFile {};
+        // replay a recorded session headless & report the frame times (--replay)
+        std::basic_string<char> replayFile {};
+        // where the replay report goes, stdout if empty (--report)
+        std::basic_string<char> reportFile {};
+        // write a Chrome trace of the session to this file (--trace)
+        std::basic_string<char> traceFile {};
+        // auto (follows the power source), performance or saver (--power)
+        std::basic_string<char> powerProfile {"auto"};
+        // straight or premultiplied, how image & text alpha is uploaded (--alpha)
+        std::basic_string<char> alphaMode {"straight"};
+        // seconds a scene has to be unused before its assets are released (--release-after)
+        int releaseAfter {30};
+        // time zones shown as extra clocks in the main scene, in order (--clock, repeatable)
+        std::vector<std::basic_string<char>> clockZones {};
+        // cpu (the scenes are composited into one frame) or sdl (every image & fill through the renderer) (--draw)
+        std::basic_string<char> drawMode {"cpu"};
+    };
+
     class Anya final {
     public:
-        Anya();
+        explicit Anya(const LaunchOptions &options = {});
 
-        std::basic_string<char> timeToStr(const std::chrono::system_clock::time_point &time);
+        static std::basic_string<char> timeToStr(const std::chrono::system_clock::time_point &time);
         bool boot();
         void update();
         void draw();
         void free();
 
+    private:
+        // something on screen changes every frame (not counting button fades)
+        bool isAnimating();
+        // time until the clock has to be redrawn (ms)
+        int idleTimeout();
+        // everything a scene shows, into the current render target
+        void drawScene(Helper::SceneID scene);
+        // the background, date & time of the main scene
+        void drawMainBackground();
+        // blurs a snapshot of the main scene for the settings menus, only when what it shows has changed
+        void refreshBackdrop();
+        // the blurred main scene dimmed with the menu colour
+        void drawBackdrop(const SDL_Rect &view);
+        // points the images, buttons & clocks at a compositor, nullptr for the renderer
+        void setDrawTarget(Helper::Compositor *target);
+        // a filled rectangle into the draw target
+        void fillRect(const SDL_Rect &rect, const SDL_Color &col);
+        // snapshots both scenes for a transition (a cut for the minimal window, it changes size)
+        void startTransition(Helper::SceneID previous, Helper::SceneID current);
+        // builds the gif pack if it is not (main scene manifest)
+        int loadBackgroundGIF();
+        // a manifest of declared images, loaded & released together
+        Helper::SceneManifest imageManifest(std::vector<Helper::ImageHandle> images,
+                                            std::vector<Helper::SceneID> next);
+
     private:
         // window data
         std::basic_string<char> title {"anya"};
@@ -52,9 +118,24 @@ namespace Application {
         std::unique_ptr<Helper::UInterface> interfacePtr {nullptr};
         std::unique_ptr<Helper::Image> imagePtr {nullptr};
         std::unique_ptr<Helper::Scene> scenePtr {nullptr};
+        std::unique_ptr<Helper::ColorPicker> colorPickerPtr {nullptr};
+        std::unique_ptr<Helper::WorldClock> worldClockPtr {nullptr};
+        std::unique_ptr<Helper::Transition> transitionPtr {nullptr};
+        // frame phases, F3 shows the graph
+        Helper::Profiler profiler {};
+        LaunchOptions options {};
+        Helper::Replay replay {};
+        // frame rate by window visibility, focus & power source
+        Helper::PowerPolicy power {};
+        // memory per subsystem & the high-water mark of every scene, F4 (or SIGUSR1) prints it
+        Helper::MemoryReport memoryReport {};
+        // modifier keys of the last key event (replays the same as it was recorded)
+        uint16_t keyMods {KMOD_NONE};
         // directory path
         std::basic_string<char> dirPath;
         std::basic_string<char> typographyStr;
+        // bumped when the font changes (what the backdrop is keyed on instead of the path)
+        uint32_t typographyVersion {0};
         // set background colour
         int redViewColor {0};
         int greenViewColor {0};
@@ -79,6 +160,21 @@ namespace Application {
         SDL_Rect colorPickerBounds;
         SDL_Rect colorSliderBounds;
         SDL_Rect themesColorPicker;
+        // the last colour picked in the theme creator
+        SDL_Color pickedColor {255, 255, 255, 255};
+        // background of the settings menus
+        SDL_Color menuColor {26, 17, 16, 255};
+        // every scene but the theme creator is composited into this frame on the cpu (--draw cpu)
+        Helper::Compositor sceneFrame {};
+        bool compositing {false};
+        // the blurred & dimmed main scene behind the settings menus
+        Helper::Compositor backdrop {};
+        Helper::ImageHandle backdropTarget {};
+        Helper::Layer backdropLayer {};
+        // hash of what the backdrop shows, 0 until it is first drawn
+        uint64_t backdropKey {0};
+        // how much of the menu colour is laid over the blurred backdrop
+        uint8_t backdropDim {170};
         // replace with non-filled circle
         SDL_Vertex themesSlider[3];
         SDL_Vertex themesSliderOutline[3];
@@ -87,69 +183,47 @@ namespace Application {
         HWND hwnd;
 #endif
 
-        Helper::IMD backgroundGIF {nullptr};
-        Helper::IMD backgroundImg {nullptr};
-        Helper::IMD githubImg {nullptr};
-        Helper::IMD calendarImg {nullptr};
-        Helper::IMD typographyImg {nullptr};
-        Helper::IMD returnImg {nullptr};
-        Helper::IMD setThemeImg {nullptr};
+        Helper::ImageHandle backgroundGIF {};
+        Helper::ImageHandle backgroundImg {};
+        Helper::ImageHandle githubImg {};
+        Helper::ImageHandle calendarImg {};
+        Helper::ImageHandle typographyImg {};
+        Helper::ImageHandle returnImg {};
+        Helper::ImageHandle setThemeImg {};
         // text
-        Helper::IMD timeText {nullptr};
-        Helper::IMD dateText {nullptr};
-        Helper::IMD settingsText {nullptr};
-        Helper::IMD mainQuitText {nullptr};
-        Helper::IMD minimizeText {nullptr};
-        Helper::IMD quitText {nullptr};
-        Helper::IMD settingsExitText {nullptr};
-        Helper::IMD themesText {nullptr};
-        Helper::IMD themesExitText {nullptr};
-        // Helper::IMD setLayoutText {nullptr};
-        Helper::IMD minimalText {nullptr};
-        Helper::IMD setBGText {nullptr};
-        Helper::IMD openFileText {nullptr};
-        Helper::IMD bgColorInputText {nullptr};
-        Helper::IMD typographyInputText {nullptr};
-
-        ////////////////////////////////
-        // test for button/menu theming
-        Helper::IMD themesMenuBGText {nullptr};
-        Helper::IMD themesBGCText {nullptr};
-        Helper::IMD themesOCText {nullptr};
-        Helper::IMD themesTCText {nullptr};
-        Helper::IMD buttonColorInputText {nullptr};
-        Helper::IMD exitThemeCreatorText {nullptr};
-        ////////////////////////////////
+        Helper::ImageHandle timeText {};
+        Helper::ImageHandle dateText {};
+        // Helper::ImageHandle setLayoutText {};
 
         // buttons
-        Helper::BUTTONPTR settingsBtn {nullptr};
-        Helper::BUTTONPTR mainQuitBtn {nullptr};
-        Helper::BUTTONPTR minimizeBtn {nullptr};
-        Helper::BUTTONPTR returnBtn {nullptr};
-        Helper::BUTTONPTR settingsQuitBtn {nullptr};
-        Helper::BUTTONPTR settingsExitBtn {nullptr};
-        Helper::BUTTONPTR themesBtn {nullptr};
-        Helper::BUTTONPTR githubBtn {nullptr};
-        Helper::BUTTONPTR calendarBtn {nullptr};
-        // Helper::BUTTONPTR setLayoutBtn {nullptr};
-        Helper::BUTTONPTR themesExitBtn {nullptr};
-        Helper::BUTTONPTR minimalBtn {nullptr};
-        Helper::BUTTONPTR setBGBtn {nullptr};
-        Helper::BUTTONPTR openFileBtn {nullptr};
-        Helper::BUTTONPTR bgColorInputBtn {nullptr};
-        Helper::BUTTONPTR setTypographyBtn {nullptr};
-        Helper::BUTTONPTR typographyInputBtn {nullptr};
-        Helper::BUTTONPTR setThemeBtn {nullptr};
+        Helper::ButtonID settingsBtn {Helper::noButton};
+        Helper::ButtonID mainQuitBtn {Helper::noButton};
+        Helper::ButtonID minimizeBtn {Helper::noButton};
+        Helper::ButtonID returnBtn {Helper::noButton};
+        Helper::ButtonID settingsQuitBtn {Helper::noButton};
+        Helper::ButtonID settingsExitBtn {Helper::noButton};
+        Helper::ButtonID themesBtn {Helper::noButton};
+        Helper::ButtonID githubBtn {Helper::noButton};
+        Helper::ButtonID calendarBtn {Helper::noButton};
+        // Helper::ButtonID setLayoutBtn {Helper::noButton};
+        Helper::ButtonID themesExitBtn {Helper::noButton};
+        Helper::ButtonID minimalBtn {Helper::noButton};
+        Helper::ButtonID setBGBtn {Helper::noButton};
+        Helper::ButtonID openFileBtn {Helper::noButton};
+        Helper::ButtonID bgColorInputBtn {Helper::noButton};
+        Helper::ButtonID setTypographyBtn {Helper::noButton};
+        Helper::ButtonID typographyInputBtn {Helper::noButton};
+        Helper::ButtonID setThemeBtn {Helper::noButton};
 
         ////////////////////////////////
         // test for button/menu theming
-        Helper::BUTTONPTR setMenuBGBtn {nullptr};
-        Helper::BUTTONPTR setButtonBGCBtn {nullptr};
-        Helper::BUTTONPTR setButtonOCBtn {nullptr};
-        Helper::BUTTONPTR setButtonTCBtn {nullptr};
-        Helper::BUTTONPTR exitThemeCreatorBtn {nullptr};
+        Helper::ButtonID setMenuBGBtn {Helper::noButton};
+        Helper::ButtonID setButtonBGCBtn {Helper::noButton};
+        Helper::ButtonID setButtonOCBtn {Helper::noButton};
+        Helper::ButtonID setButtonTCBtn {Helper::noButton};
+        Helper::ButtonID exitThemeCreatorBtn {Helper::noButton};
         // set the enter key to submit the value based on the button selected
-        Helper::BUTTONPTR buttonColorInputBtn {nullptr};
+        Helper::ButtonID buttonColorInputBtn {Helper::noButton};
         ////////////////////////////////
     };
 } // namespace Application
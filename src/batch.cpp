@@ -0,0 +1,248 @@
+#include "batch.hpp"
+#include "compositor.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        bool overlaps(const SDL_FRect &a, const SDL_FRect &b) noexcept {
+            return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+        }
+
+        SDL_FRect merge(const SDL_FRect &a, const SDL_FRect &b) noexcept {
+            const float x1 = std::min(a.x, b.x);
+            const float y1 = std::min(a.y, b.y);
+            const float x2 = std::max(a.x + a.w, b.x + b.w);
+            const float y2 = std::max(a.y + a.h, b.y + b.h);
+
+            return {x1, y1, x2 - x1, y2 - y1};
+        }
+
+        SDL_FRect toFRect(const SDL_Rect &rect) noexcept {
+            return {static_cast<float>(rect.x), static_cast<float>(rect.y), static_cast<float>(rect.w),
+                    static_cast<float>(rect.h)};
+        }
+    } // namespace
+
+    Batch::Group &Batch::findGroup(SDL_Texture *texture, const SDL_FRect &area) {
+        // walk back to the last group of the texture, stop at anything drawn later that the area overlaps
+        for (size_t i = groupCount; i-- > 0;) {
+            Group &group = groups[i];
+            if (group.texture == texture) {
+                group.bounds = group.indices.empty() ? area : merge(group.bounds, area);
+                return group;
+            }
+
+            if (!group.indices.empty() && overlaps(group.bounds, area))
+                break;
+        }
+
+        if (groupCount == groups.size())
+            groups.emplace_back();
+
+        Group &group = groups[groupCount++];
+        group.texture = texture;
+        group.bounds = area;
+        group.vertices.clear();
+        group.indices.clear();
+
+        return group;
+    }
+
+    void Batch::addQuad(SDL_Texture *texture, const SDL_FRect &area, const SDL_Color (&col)[4], const SDL_FPoint &uv0,
+                        const SDL_FPoint &uv1) {
+        if (area.w <= 0.0f || area.h <= 0.0f)
+            return;
+
+        Group &group = findGroup(texture, area);
+        const int base = static_cast<int>(group.vertices.size());
+        const float x2 = area.x + area.w;
+        const float y2 = area.y + area.h;
+
+        // top left, top right, bottom left, bottom right
+        group.vertices.push_back({{area.x, area.y}, col[0], {uv0.x, uv0.y}});
+        group.vertices.push_back({{x2, area.y}, col[1], {uv1.x, uv0.y}});
+        group.vertices.push_back({{area.x, y2}, col[2], {uv0.x, uv1.y}});
+        group.vertices.push_back({{x2, y2}, col[3], {uv1.x, uv1.y}});
+
+        const int indices[] = {base, base + 1, base + 3, base, base + 2, base + 3};
+        group.indices.insert(group.indices.end(), std::begin(indices), std::end(indices));
+    }
+
+    void Batch::fillRect(const SDL_Rect &rect, const SDL_Color &col, SDL_Renderer *ren) {
+        if (drawTarget != nullptr) {
+            drawTarget->fillRect(rect, col);
+            return;
+        }
+
+        if (immediate) {
+            SDL_SetRenderDrawColor(ren, col.r, col.g, col.b, col.a);
+            SDL_RenderFillRect(ren, &rect);
+            callCount += 2;
+            return;
+        }
+
+        const SDL_Color cols[4] = {col, col, col, col};
+        addQuad(nullptr, toFRect(rect), cols, {0.0f, 0.0f}, {0.0f, 0.0f});
+    }
+
+    void Batch::drawRect(const SDL_Rect &rect, const SDL_Color &col, SDL_Renderer *ren) {
+        if (immediate && drawTarget == nullptr) {
+            SDL_SetRenderDrawColor(ren, col.r, col.g, col.b, col.a);
+            SDL_RenderDrawRect(ren, &rect);
+            callCount += 2;
+            return;
+        }
+
+        if (rect.w <= 0 || rect.h <= 0)
+            return;
+
+        // top & bottom rows, then the sides between them
+        fillRect({rect.x, rect.y, rect.w, 1}, col, ren);
+        if (rect.h > 1)
+            fillRect({rect.x, rect.y + rect.h - 1, rect.w, 1}, col, ren);
+
+        if (rect.h > 2) {
+            fillRect({rect.x, rect.y + 1, 1, rect.h - 2}, col, ren);
+            if (rect.w > 1)
+                fillRect({rect.x + rect.w - 1, rect.y + 1, 1, rect.h - 2}, col, ren);
+        }
+    }
+
+    void Batch::drawGradient(float x1, float y1, float x2, float y2, const SDL_Color &initial, const SDL_Color &end,
+                             SDL_Renderer *ren) {
+        const SDL_Color cols[4] = {initial, initial, end, end};
+        if (drawTarget != nullptr) {
+            // the colour of the centre of every row, the same edges as a filled rect
+            const int left = static_cast<int>(std::lround(x1));
+            const int right = static_cast<int>(std::lround(x2));
+            const int top = static_cast<int>(std::lround(y1));
+            const int bottom = static_cast<int>(std::lround(y2));
+            const float height = y2 - y1;
+            const auto mix = [](uint8_t a, uint8_t b, float t) {
+                return static_cast<uint8_t>(std::lround(static_cast<float>(a) + (b - a) * t));
+            };
+
+            for (int y = top; y < bottom; ++y) {
+                const float t = (height > 0.0f) ? std::clamp((y + 0.5f - y1) / height, 0.0f, 1.0f) : 0.0f;
+                drawTarget->fillRect({left, y, right - left, 1},
+                                     {mix(initial.r, end.r, t), mix(initial.g, end.g, t), mix(initial.b, end.b, t),
+                                      mix(initial.a, end.a, t)});
+            }
+            return;
+        }
+
+        if (immediate) {
+            const SDL_Vertex vert[4] = {
+                {{x1, y1}, initial, {0.0f, 0.0f}},
+                {{x2, y1}, initial, {0.0f, 0.0f}},
+                {{x1, y2}, end, {0.0f, 0.0f}},
+                {{x2, y2}, end, {0.0f, 0.0f}},
+            };
+            const int indices[] = {0, 1, 3, 0, 2, 3};
+
+            SDL_RenderGeometry(ren, nullptr, vert, 4, indices, 6);
+            ++callCount;
+            return;
+        }
+
+        addQuad(nullptr, {x1, y1, x2 - x1, y2 - y1}, cols, {0.0f, 0.0f}, {0.0f, 0.0f});
+    }
+
+    void Batch::drawTexture(SDL_Texture *texture, const SDL_Rect *clip, const SDL_Rect &dst, SDL_Renderer *ren,
+                            const Layer *layer) {
+        if (texture == nullptr)
+            return;
+
+        if (drawTarget != nullptr) {
+            if (layer == nullptr) {
+                if (!warnedReadBack) {
+                    println("Texture drawn without a layer, reading it back from the texture");
+                    warnedReadBack = true;
+                }
+                if (Compositor::readLayer(texture, ren, readBack) != 0)
+                    return;
+                layer = &readBack;
+            }
+
+            SDL_Color mod {255, 255, 255, 255};
+            SDL_GetTextureColorMod(texture, &mod.r, &mod.g, &mod.b);
+            SDL_GetTextureAlphaMod(texture, &mod.a);
+            // the modulation of a straight alpha texture, its premultiplied layer needs the colour scaled by alpha
+            SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+            SDL_GetTextureBlendMode(texture, &mode);
+            if (layer->premultiplied && mode == SDL_BLENDMODE_BLEND)
+                mod = premultiplyMod(mod);
+            drawTarget->blendScaled(*layer, clip, dst, mod);
+            return;
+        }
+
+        if (immediate) {
+            SDL_RenderCopy(ren, texture, clip, &dst);
+            ++callCount;
+            return;
+        }
+
+        SDL_FPoint uv0 {0.0f, 0.0f};
+        SDL_FPoint uv1 {1.0f, 1.0f};
+        if (clip != nullptr) {
+            int w = 0;
+            int h = 0;
+            if (SDL_QueryTexture(texture, nullptr, nullptr, &w, &h) != 0 || w <= 0 || h <= 0)
+                return;
+
+            uv0 = {static_cast<float>(clip->x) / w, static_cast<float>(clip->y) / h};
+            uv1 = {static_cast<float>(clip->x + clip->w) / w, static_cast<float>(clip->y + clip->h) / h};
+        }
+
+        // SDL_RenderGeometry only uses the vertex colour, carry the texture modulation over
+        SDL_Color mod {255, 255, 255, 255};
+        SDL_GetTextureColorMod(texture, &mod.r, &mod.g, &mod.b);
+        SDL_GetTextureAlphaMod(texture, &mod.a);
+
+        const SDL_Color cols[4] = {mod, mod, mod, mod};
+        addQuad(texture, toFRect(dst), cols, uv0, uv1);
+    }
+
+    int Batch::flush(SDL_Renderer *ren) {
+        int result = 0;
+        for (size_t i = 0; i < groupCount; ++i) {
+            Group &group = groups[i];
+            if (group.indices.empty())
+                continue;
+
+            if (SDL_RenderGeometry(ren, group.texture, group.vertices.data(), static_cast<int>(group.vertices.size()),
+                                   group.indices.data(), static_cast<int>(group.indices.size())) != 0) {
+                panicln("Failed to render batch");
+                result = -1;
+            }
+            ++callCount;
+
+            group.vertices.clear();
+            group.indices.clear();
+        }
+
+        groupCount = 0;
+
+        return result;
+    }
+
+    void Batch::setImmediate(bool drawImmediately) noexcept {
+        immediate = drawImmediately;
+    }
+
+    void Batch::setDrawTarget(Compositor *target) noexcept {
+        drawTarget = target;
+    }
+
+    uint64_t Batch::getCallCount() const noexcept {
+        return callCount;
+    }
+
+    void Batch::resetCallCount() noexcept {
+        callCount = 0;
+    }
+} // namespace Application::Helper
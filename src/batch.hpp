@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL.h>
+#include "data.hpp"
+#include <cstdint>
+#include <vector>
+
+/** Structure
+ *
+ * Batch -> collects fills, outlines, gradients & textured quads as triangles and submits them with SDL_RenderGeometry
+ * Group -> the vertices & indices of one texture (nullptr for plain colour), one SDL_RenderGeometry call each
+ * Order -> a primitive joins the last group of its texture only if it overlaps nothing drawn after that group,
+ *          otherwise a new group is started, so the result matches drawing everything in order
+ * Immediate -> draws every primitive right away with the classic SDL calls (for comparing the two)
+ * Compositor -> while one is the draw target every primitive goes straight into its frame, in order; a gradient
+ *               is a fill per row & a texture is drawn from its layer (read back from the texture without one)
+ */
+
+namespace Application::Helper {
+    class Compositor;
+
+    class Batch final {
+    public:
+        /** Adds a filled rectangle.
+         *
+         * \param rect -> the area to fill
+         * \param col -> colour of the rectangle
+         * \param ren -> the renderer to use (only used when drawing immediately)
+         */
+        void fillRect(const SDL_Rect &rect, const SDL_Color &col, SDL_Renderer *ren);
+        /** Adds a rectangle outline (1px, same pixels as SDL_RenderDrawRect).
+         *
+         * \param rect -> the rectangle to outline
+         * \param col -> colour of the outline
+         * \param ren -> the renderer to use (only used when drawing immediately)
+         */
+        void drawRect(const SDL_Rect &rect, const SDL_Color &col, SDL_Renderer *ren);
+        /** Adds a vertical gradient between select points.
+         *
+         * \param x1 -> x position for the top and bottom left point
+         * \param y1 -> y position for the top left and right point
+         * \param x2 -> x position for the top and bottom right point
+         * \param y2 -> y position for the bottom left and right point
+         * \param initial -> colour of the top
+         * \param end -> colour of the bottom
+         * \param ren -> the renderer to use (only used when drawing immediately)
+         */
+        void drawGradient(float x1, float y1, float x2, float y2, const SDL_Color &initial, const SDL_Color &end,
+                          SDL_Renderer *ren);
+        /** Adds a textured quad, the texture's colour & alpha modulation are applied.
+         *
+         * \param texture -> the texture to draw (nullptr is skipped)
+         * \param clip -> (optional) the part of the texture to draw, the whole texture by default
+         * \param dst -> where to draw the texture
+         * \param ren -> the renderer to use (only used when drawing immediately)
+         * \param layer -> (optional) the pixels of the texture on the CPU, drawn instead while compositing
+         */
+        void drawTexture(SDL_Texture *texture, const SDL_Rect *clip, const SDL_Rect &dst, SDL_Renderer *ren,
+                         const Layer *layer = nullptr);
+        /** Submits everything added since the last flush, one SDL_RenderGeometry call per group.
+         *
+         * \param ren -> the renderer to use
+         * \return 0 if the operation succeeded, otherwise -1 if a group failed to render.
+         */
+        int flush(SDL_Renderer *ren);
+        /** Switches between batching and drawing every primitive right away.
+         *
+         * \param drawImmediately -> true to draw right away, false to batch
+         */
+        void setImmediate(bool drawImmediately) noexcept;
+        /** Draws into a compositor's frame instead of through the renderer (flush the batch first).
+         *
+         * \param target -> the compositor to draw into, nullptr to draw through the renderer
+         */
+        void setDrawTarget(Compositor *target) noexcept;
+        /** Gets the number of renderer calls made (draw colour, fill, copy & geometry calls).
+         *
+         * \return the calls made since the last reset.
+         */
+        uint64_t getCallCount() const noexcept;
+        /* Resets the renderer call count.
+         */
+        void resetCallCount() noexcept;
+
+    private:
+        struct Group final {
+            SDL_Texture *texture {nullptr};
+            // everything in the group, used for the overlap test
+            SDL_FRect bounds {0};
+            std::vector<SDL_Vertex> vertices {};
+            std::vector<int> indices {};
+        };
+
+        Group &findGroup(SDL_Texture *texture, const SDL_FRect &area);
+        void addQuad(SDL_Texture *texture, const SDL_FRect &area, const SDL_Color (&col)[4], const SDL_FPoint &uv0,
+                     const SDL_FPoint &uv1);
+
+    private:
+        // groups are kept between frames so their buffers are reused
+        std::vector<Group> groups {};
+        size_t groupCount {0};
+        uint64_t callCount {0};
+        bool immediate {false};
+        Compositor *drawTarget {nullptr};
+        // a texture drawn into the compositor without a layer, read back on every draw
+        Layer readBack {};
+        bool warnedReadBack {false};
+    };
+} // namespace Application::Helper
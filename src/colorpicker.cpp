@@ -0,0 +1,157 @@
+#include "colorpicker.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        // f(n) = v - v * s * clamp(min(k, 4 - k), 0, 1) where k = (n + 6h) mod 6, n is 5 (red), 3 (green), 1 (blue)
+        inline uint32_t channel(float n, float h, float s, float v) noexcept {
+            float k = n + h * 6.0f;
+            // k is never negative, truncating is the same as flooring
+            k -= 6.0f * static_cast<float>(static_cast<int>(k * (1.0f / 6.0f)));
+            const float t = std::clamp(std::min(k, 4.0f - k), 0.0f, 1.0f);
+            // round to nearest even like the vector path
+            return static_cast<uint32_t>(std::nearbyint((v - v * s * t) * 255.0f));
+        }
+
+#if ANYA_SSE2
+        inline __m128i channel(__m128 n, __m128 h6, __m128 vs, __m128 v) noexcept {
+            const __m128 six = _mm_set1_ps(6.0f);
+            __m128 k = _mm_add_ps(n, h6);
+            const __m128 q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(k, _mm_set1_ps(1.0f / 6.0f))));
+            k = _mm_sub_ps(k, _mm_mul_ps(q, six));
+
+            __m128 t = _mm_min_ps(k, _mm_sub_ps(_mm_set1_ps(4.0f), k));
+            t = _mm_max_ps(_mm_min_ps(t, _mm_set1_ps(1.0f)), _mm_setzero_ps());
+
+            return _mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(v, _mm_mul_ps(vs, t)), _mm_set1_ps(255.0f)));
+        }
+#endif
+    } // namespace
+
+    void hsvToRgb(const float *h, const float *s, const float *v, uint32_t *out, size_t count) noexcept {
+        size_t i = 0;
+#if ANYA_SSE2
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 4 <= count; i += 4) {
+            const __m128 h6 = _mm_mul_ps(_mm_loadu_ps(h + i), _mm_set1_ps(6.0f));
+            const __m128 vv = _mm_loadu_ps(v + i);
+            const __m128 vs = _mm_mul_ps(vv, _mm_loadu_ps(s + i));
+
+            const __m128i r = channel(_mm_set1_ps(5.0f), h6, vs, vv);
+            const __m128i g = channel(_mm_set1_ps(3.0f), h6, vs, vv);
+            const __m128i b = channel(_mm_set1_ps(1.0f), h6, vs, vv);
+
+            const __m128i rgb = _mm_or_si128(_mm_slli_epi32(r, 16), _mm_or_si128(_mm_slli_epi32(g, 8), b));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_or_si128(rgb, alpha));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = 0xFF000000u | (channel(5.0f, h[i], s[i], v[i]) << 16) | (channel(3.0f, h[i], s[i], v[i]) << 8) |
+                     channel(1.0f, h[i], s[i], v[i]);
+        }
+    }
+
+    int ColorPicker::create(SDL_Renderer *ren, const SDL_Rect &square, const SDL_Rect &strip) {
+        squareRect = square;
+        stripRect = strip;
+
+        squareTexture = cheesecake(
+            SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, square.w, square.h));
+        stripTexture = cheesecake(
+            SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, strip.w, strip.h));
+        if (squareTexture == nullptr || stripTexture == nullptr) {
+            panicln("Failed to create colour picker");
+            return -1;
+        }
+
+        // saturation goes right, value goes down
+        const size_t squareCount = static_cast<size_t>(square.w) * square.h;
+        squarePixels.resize(squareCount);
+        squareHue.resize(squareCount);
+        squareSat.resize(squareCount);
+        squareVal.resize(squareCount);
+        for (int y = 0; y < square.h; ++y) {
+            for (int x = 0; x < square.w; ++x) {
+                const size_t i = static_cast<size_t>(y) * square.w + x;
+                squareSat[i] = (square.w > 1) ? static_cast<float>(x) / static_cast<float>(square.w - 1) : 1.0f;
+                squareVal[i] = (square.h > 1) ? 1.0f - static_cast<float>(y) / static_cast<float>(square.h - 1) : 1.0f;
+            }
+        }
+
+        generateStrip();
+        generateSquare();
+
+        return 0;
+    }
+
+    void ColorPicker::generateStrip() noexcept {
+        // one hue per row, full saturation & value
+        std::vector<float> hues(stripRect.h);
+        std::vector<float> ones(stripRect.h, 1.0f);
+        std::vector<uint32_t> column(stripRect.h);
+        for (int y = 0; y < stripRect.h; ++y)
+            hues[y] = static_cast<float>(y) / static_cast<float>(stripRect.h);
+
+        hsvToRgb(hues.data(), ones.data(), ones.data(), column.data(), column.size());
+
+        stripPixels.resize(static_cast<size_t>(stripRect.w) * stripRect.h);
+        for (int y = 0; y < stripRect.h; ++y)
+            std::fill_n(stripPixels.begin() + static_cast<ptrdiff_t>(y) * stripRect.w, stripRect.w, column[y]);
+
+        SDL_UpdateTexture(stripTexture.get(), nullptr, stripPixels.data(), stripRect.w * 4);
+    }
+
+    void ColorPicker::generateSquare() noexcept {
+        std::fill(squareHue.begin(), squareHue.end(), hue);
+        hsvToRgb(squareHue.data(), squareSat.data(), squareVal.data(), squarePixels.data(), squarePixels.size());
+        squareDirty = true;
+    }
+
+    void ColorPicker::setHue(float newHue) noexcept {
+        newHue = std::clamp(newHue, 0.0f, 1.0f);
+        if (newHue == hue)
+            return;
+
+        hue = newHue;
+        generateSquare();
+    }
+
+    void ColorPicker::setHueAt(int y) noexcept {
+        if (stripRect.h <= 0)
+            return;
+
+        const int row = std::clamp(y - stripRect.y, 0, stripRect.h - 1);
+        setHue(static_cast<float>(row) / static_cast<float>(stripRect.h));
+    }
+
+    float ColorPicker::getHue() const noexcept {
+        return hue;
+    }
+
+    SDL_Color ColorPicker::pick(int x, int y) const noexcept {
+        if (squarePixels.empty())
+            return {0, 0, 0, 255};
+
+        const int px = std::clamp(x - squareRect.x, 0, squareRect.w - 1);
+        const int py = std::clamp(y - squareRect.y, 0, squareRect.h - 1);
+        const uint32_t pixel = squarePixels[static_cast<size_t>(py) * squareRect.w + px];
+
+        return {static_cast<uint8_t>(pixel >> 16), static_cast<uint8_t>(pixel >> 8), static_cast<uint8_t>(pixel),
+                SDL_ALPHA_OPAQUE};
+    }
+
+    void ColorPicker::draw(SDL_Renderer *ren) noexcept {
+        // upload only after the hue changed
+        if (squareDirty) {
+            SDL_UpdateTexture(squareTexture.get(), nullptr, squarePixels.data(), squareRect.w * 4);
+            squareDirty = false;
+        }
+
+        SDL_RenderCopy(ren, stripTexture.get(), nullptr, &stripRect);
+        SDL_RenderCopy(ren, squareTexture.get(), nullptr, &squareRect);
+    }
+} // namespace Application::Helper
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <SDL.h>
+#include "util.hpp"
+#include <cstdint>
+#include <vector>
+
+/** Structure
+ *
+ * ColorPicker -> an HSV saturation/value square & a hue strip, generated on the CPU into streaming textures
+ * Kernel -> branch-free HSV to RGB conversion, 4 pixels at a time (SSE2) with a scalar tail
+ * Pick -> colours are read back from the generated pixels (no SDL_RenderReadPixels)
+ */
+
+namespace Application::Helper {
+    /** Converts HSV colours to packed ARGB8888 pixels.
+     *
+     * \param h -> hue of each pixel (0 to 1, 1 wraps back to red)
+     * \param s -> saturation of each pixel (0 to 1)
+     * \param v -> value of each pixel (0 to 1)
+     * \param out -> the converted pixels
+     * \param count -> the number of pixels to convert
+     */
+    void hsvToRgb(const float *h, const float *s, const float *v, uint32_t *out, size_t count) noexcept;
+
+    class ColorPicker final {
+    public:
+        /** Creates the picker textures and generates the hue strip & the square for the current hue.
+         *
+         * \param ren -> the renderer to use
+         * \param square -> the area of the saturation (x) & value (y) square
+         * \param strip -> the area of the hue strip (hue goes down the strip)
+         * \return 0 if the operation succeeded, otherwise -1 if it failed.
+         */
+        int create(SDL_Renderer *ren, const SDL_Rect &square, const SDL_Rect &strip);
+        /** Sets the hue of the square, the square is only generated again if the hue changed.
+         *
+         * \param newHue -> the hue to use (0 to 1)
+         */
+        void setHue(float newHue) noexcept;
+        /** Sets the hue from a position on the hue strip.
+         *
+         * \param y -> y position of the cursor (clamped to the strip)
+         */
+        void setHueAt(int y) noexcept;
+        /** Gets the current hue of the square.
+         *
+         * \return the hue (0 to 1).
+         */
+        float getHue() const noexcept;
+        /** Picks the colour under a position in the square.
+         *
+         * \param x -> x position of the cursor (clamped to the square)
+         * \param y -> y position of the cursor (clamped to the square)
+         * \return the exact colour that is drawn at that position.
+         */
+        SDL_Color pick(int x, int y) const noexcept;
+        /** Renders the square & hue strip to the screen.
+         *
+         * \param ren -> the renderer to use
+         */
+        void draw(SDL_Renderer *ren) noexcept;
+
+    private:
+        void generateSquare() noexcept;
+        void generateStrip() noexcept;
+
+    private:
+        SDL_Rect squareRect {0};
+        SDL_Rect stripRect {0};
+        Utils::SMD<SDL_Texture> squareTexture {nullptr};
+        Utils::SMD<SDL_Texture> stripTexture {nullptr};
+        std::vector<uint32_t> squarePixels {};
+        std::vector<uint32_t> stripPixels {};
+        // saturation & value of every pixel in the square, these never change
+        std::vector<float> squareSat {};
+        std::vector<float> squareVal {};
+        std::vector<float> squareHue {};
+        float hue {0.0f};
+        bool squareDirty {true};
+    };
+} // namespace Application::Helper
@@ -0,0 +1,796 @@
+#include "compositor.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        using BlendRow = void (*)(uint32_t *dst, const uint32_t *src, size_t count, const SDL_Color &mod);
+        using FillRow = void (*)(uint32_t *dst, size_t count, const SDL_Color &col);
+        using PixelRow = void (*)(uint32_t *pixels, size_t count);
+        using KeyRow = void (*)(uint32_t *pixels, size_t count, uint32_t key, uint32_t tolerance);
+        using BlurRow = void (*)(const uint32_t *src, size_t count, uint32_t *dst, size_t dstStride, int radius);
+
+        struct Kernels final {
+            BlendRow blendRow;
+            BlendRow blendPremultipliedRow;
+            FillRow fillRow;
+            PixelRow premultiplyRow;
+            KeyRow colorKeyRow;
+            BlurRow blurRow;
+        };
+
+        // x / 255 rounded to nearest, exact for x <= 255 * 255 (the vector kernels use the same formula)
+        inline uint32_t div255(uint32_t x) noexcept {
+            return ((x + 128) * 257) >> 16;
+        }
+
+        inline uint32_t blendPixel(uint32_t d, uint32_t s, const SDL_Color &mod) noexcept {
+            const uint32_t a = div255((s >> 24) * mod.a);
+            if (a == 0)
+                return d;
+
+            // the alpha channel blends 255, so it ends up as a + dst * (1 - a)
+            const uint32_t inv = 255 - a;
+            const uint32_t r = div255(div255(((s >> 16) & 0xFF) * mod.r) * a + ((d >> 16) & 0xFF) * inv);
+            const uint32_t g = div255(div255(((s >> 8) & 0xFF) * mod.g) * a + ((d >> 8) & 0xFF) * inv);
+            const uint32_t b = div255(div255((s & 0xFF) * mod.b) * a + (d & 0xFF) * inv);
+            const uint32_t outA = div255(255 * a + (d >> 24) * inv);
+
+            return (outA << 24) | (r << 16) | (g << 8) | b;
+        }
+
+        void blendRowScalar(uint32_t *dst, const uint32_t *src, size_t count, const SDL_Color &mod) {
+            for (size_t i = 0; i < count; ++i)
+                dst[i] = blendPixel(dst[i], src[i], mod);
+        }
+
+        // SDL's one + one minus source alpha (Image's premultiplied blend mode), the modulation is applied as given
+        inline uint32_t blendPremultipliedPixel(uint32_t d, uint32_t s, const SDL_Color &mod) noexcept {
+            if (s == 0)
+                return d;
+
+            const uint32_t inv = 255 - div255((s >> 24) * mod.a);
+            const uint32_t r = div255(((s >> 16) & 0xFF) * mod.r) + div255(((d >> 16) & 0xFF) * inv);
+            const uint32_t g = div255(((s >> 8) & 0xFF) * mod.g) + div255(((d >> 8) & 0xFF) * inv);
+            const uint32_t b = div255((s & 0xFF) * mod.b) + div255((d & 0xFF) * inv);
+            const uint32_t outA = (255 - inv) + div255((d >> 24) * inv);
+
+            // a colour over its alpha (not premultiplied properly) saturates
+            return (std::min(outA, 255u) << 24) | (std::min(r, 255u) << 16) | (std::min(g, 255u) << 8) |
+                   std::min(b, 255u);
+        }
+
+        void blendPremultipliedRowScalar(uint32_t *dst, const uint32_t *src, size_t count, const SDL_Color &mod) {
+            for (size_t i = 0; i < count; ++i)
+                dst[i] = blendPremultipliedPixel(dst[i], src[i], mod);
+        }
+
+        void fillRowScalar(uint32_t *dst, size_t count, const SDL_Color &col) {
+            const uint32_t s = (static_cast<uint32_t>(col.a) << 24) | (col.r << 16) | (col.g << 8) | col.b;
+            for (size_t i = 0; i < count; ++i)
+                dst[i] = blendPixel(dst[i], s, {255, 255, 255, 255});
+        }
+
+        void premultiplyRowScalar(uint32_t *pixels, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t p = pixels[i];
+                const uint32_t a = p >> 24;
+                pixels[i] = (a << 24) | (div255(((p >> 16) & 0xFF) * a) << 16) | (div255(((p >> 8) & 0xFF) * a) << 8) |
+                            div255((p & 0xFF) * a);
+            }
+        }
+
+        // (x * reciprocal) >> 16 stands for x / (tolerance + 1), it is never used when the tolerance is 0
+        inline uint32_t keyReciprocal(uint32_t tolerance) noexcept {
+            return (tolerance == 0) ? 0 : (65536 + tolerance) / (tolerance + 1);
+        }
+
+        void colorKeyRowScalar(uint32_t *pixels, size_t count, uint32_t key, uint32_t tolerance) {
+            const uint32_t reciprocal = keyReciprocal(tolerance);
+            const auto distance = [](uint32_t a, uint32_t b) { return (a > b) ? a - b : b - a; };
+
+            for (size_t i = 0; i < count; ++i) {
+                const uint32_t p = pixels[i];
+                const uint32_t d = std::max({distance((p >> 16) & 0xFF, (key >> 16) & 0xFF),
+                                             distance((p >> 8) & 0xFF, (key >> 8) & 0xFF),
+                                             distance(p & 0xFF, key & 0xFF)});
+                // alpha goes from 0 at the key colour to the pixel's own alpha past the tolerance
+                const uint32_t scale = std::min(d, tolerance + 1);
+                const uint32_t a = p >> 24;
+                const uint32_t alpha = (scale == tolerance + 1) ? a : (a * scale * reciprocal) >> 16;
+
+                pixels[i] = (alpha << 24) | (p & 0xFFFFFF);
+            }
+        }
+
+        // the pixel at i with the edges repeated
+        inline uint32_t edgePixel(const uint32_t *src, size_t count, ptrdiff_t i) noexcept {
+            return src[std::clamp<ptrdiff_t>(i, 0, static_cast<ptrdiff_t>(count) - 1)];
+        }
+
+        // a running sum over 2 * radius + 1 pixels, pixel x is written to dst[x * dstStride] (a column when the
+        // stride is the height, so the second pass of a blur is the first one again)
+        void blurRowScalar(const uint32_t *src, size_t count, uint32_t *dst, size_t dstStride, int radius) {
+            const float inv = 1.0f / static_cast<float>(2 * radius + 1);
+            uint32_t sum[4] {};
+            for (ptrdiff_t i = -radius; i <= radius; ++i) {
+                const uint32_t p = edgePixel(src, count, i);
+                for (int c = 0; c < 4; ++c)
+                    sum[c] += (p >> (c * 8)) & 0xFF;
+            }
+
+            for (size_t x = 0; x < count; ++x) {
+                uint32_t out = 0;
+                for (int c = 0; c < 4; ++c)
+                    out |= static_cast<uint32_t>(std::nearbyint(static_cast<float>(sum[c]) * inv)) << (c * 8);
+                dst[x * dstStride] = out;
+
+                const uint32_t in = edgePixel(src, count, static_cast<ptrdiff_t>(x) + radius + 1);
+                const uint32_t gone = edgePixel(src, count, static_cast<ptrdiff_t>(x) - radius);
+                for (int c = 0; c < 4; ++c)
+                    sum[c] += ((in >> (c * 8)) & 0xFF) - ((gone >> (c * 8)) & 0xFF);
+            }
+        }
+
+#if ANYA_SSE2
+        // 16-bit lanes, B G R A B G R A (two pixels)
+        inline __m128i div255(__m128i x) noexcept {
+            return _mm_mulhi_epu16(_mm_add_epi16(x, _mm_set1_epi16(128)), _mm_set1_epi16(257));
+        }
+
+        inline __m128i blend2(__m128i d, __m128i s, __m128i mod) noexcept {
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            s = div255(_mm_mullo_epi16(s, mod));
+            const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                                  _MM_SHUFFLE(3, 3, 3, 3));
+            s = _mm_or_si128(_mm_andnot_si128(alphaLanes, s), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+
+            const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+            return div255(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, inv)));
+        }
+
+        void blendRowSSE2(uint32_t *dst, const uint32_t *src, size_t count, const SDL_Color &mod) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mod16 = _mm_set_epi16(mod.a, mod.r, mod.g, mod.b, mod.a, mod.r, mod.g, mod.b);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                // transparent pixels (most of a text layer) leave the frame as it is
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(s, 24), zero)) == 0xFFFF)
+                    continue;
+
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+                const __m128i lo = blend2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero), mod16);
+                const __m128i hi = blend2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero), mod16);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+
+            blendRowScalar(dst + i, src + i, count - i, mod);
+        }
+
+        inline __m128i blendPremultiplied2(__m128i d, __m128i s, __m128i mod) noexcept {
+            s = div255(_mm_mullo_epi16(s, mod));
+            const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                                  _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+
+            // the sum may pass 255 for a colour over its alpha, the pack saturates it like the scalar kernel
+            return _mm_add_epi16(s, div255(_mm_mullo_epi16(d, inv)));
+        }
+
+        void blendPremultipliedRowSSE2(uint32_t *dst, const uint32_t *src, size_t count, const SDL_Color &mod) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i mod16 = _mm_set_epi16(mod.a, mod.r, mod.g, mod.b, mod.a, mod.r, mod.g, mod.b);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                // a transparent premultiplied pixel is all zero
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF)
+                    continue;
+
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+                const __m128i lo = blendPremultiplied2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero), mod16);
+                const __m128i hi = blendPremultiplied2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero), mod16);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+
+            blendPremultipliedRowScalar(dst + i, src + i, count - i, mod);
+        }
+
+        void fillRowSSE2(uint32_t *dst, size_t count, const SDL_Color &col) {
+            const __m128i zero = _mm_setzero_si128();
+            const int a = col.a;
+            // the colour times its alpha does not change along the row
+            const __m128i sa = _mm_set_epi16(static_cast<short>(255 * a), static_cast<short>(col.r * a),
+                                             static_cast<short>(col.g * a), static_cast<short>(col.b * a),
+                                             static_cast<short>(255 * a), static_cast<short>(col.r * a),
+                                             static_cast<short>(col.g * a), static_cast<short>(col.b * a));
+            const __m128i inv = _mm_set1_epi16(static_cast<short>(255 - a));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+                const __m128i lo = div255(_mm_add_epi16(sa, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv)));
+                const __m128i hi = div255(_mm_add_epi16(sa, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+
+            fillRowScalar(dst + i, count - i, col);
+        }
+
+        // the alpha lane is multiplied by 255 so it stays the same
+        inline __m128i premultiply2(__m128i p) noexcept {
+            const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+            __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            a = _mm_or_si128(_mm_andnot_si128(alphaLanes, a), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+
+            return div255(_mm_mullo_epi16(p, a));
+        }
+
+        void premultiplyRowSSE2(uint32_t *pixels, size_t count) {
+            const __m128i zero = _mm_setzero_si128();
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto *ptr = reinterpret_cast<__m128i *>(pixels + i);
+                const __m128i p = _mm_loadu_si128(ptr);
+                _mm_storeu_si128(ptr, _mm_packus_epi16(premultiply2(_mm_unpacklo_epi8(p, zero)),
+                                                       premultiply2(_mm_unpackhi_epi8(p, zero))));
+            }
+
+            premultiplyRowScalar(pixels + i, count - i);
+        }
+
+        void colorKeyRowSSE2(uint32_t *pixels, size_t count, uint32_t key, uint32_t tolerance) {
+            const __m128i keyColor = _mm_set1_epi32(static_cast<int>(key & 0xFFFFFF));
+            const __m128i rgbMask = _mm_set1_epi32(0xFFFFFF);
+            const __m128i byteMask = _mm_set1_epi32(0xFF);
+            const __m128i limit = _mm_set1_epi32(static_cast<int>(tolerance + 1));
+            const __m128i reciprocal = _mm_set1_epi32(static_cast<int>(keyReciprocal(tolerance)));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                auto *ptr = reinterpret_cast<__m128i *>(pixels + i);
+                const __m128i p = _mm_loadu_si128(ptr);
+
+                // the largest channel distance of every pixel, in the low 16 bits of its 32-bit lane
+                const __m128i diff =
+                    _mm_and_si128(_mm_or_si128(_mm_subs_epu8(p, keyColor), _mm_subs_epu8(keyColor, p)), rgbMask);
+                const __m128i d = _mm_and_si128(
+                    _mm_max_epu8(_mm_max_epu8(diff, _mm_srli_epi32(diff, 8)), _mm_srli_epi32(diff, 16)), byteMask);
+
+                const __m128i scale = _mm_min_epi16(d, limit);
+                const __m128i a = _mm_srli_epi32(p, 24);
+                const __m128i ramp = _mm_mulhi_epu16(_mm_mullo_epi16(a, scale), reciprocal);
+                const __m128i full = _mm_cmpeq_epi32(scale, limit);
+                const __m128i alpha = _mm_or_si128(_mm_and_si128(full, a), _mm_andnot_si128(full, ramp));
+
+                _mm_storeu_si128(ptr, _mm_or_si128(_mm_and_si128(p, rgbMask), _mm_slli_epi32(alpha, 24)));
+            }
+
+            colorKeyRowScalar(pixels + i, count - i, key, tolerance);
+        }
+
+        // the four channels of a pixel in 32-bit lanes
+        inline __m128i widen(uint32_t p) noexcept {
+            const __m128i zero = _mm_setzero_si128();
+            return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(p)), zero), zero);
+        }
+
+        // the same running sum as the scalar kernel, all channels of a pixel at once (a row depends on itself, so
+        // AVX2 would not be any wider here)
+        void blurRowSSE2(const uint32_t *src, size_t count, uint32_t *dst, size_t dstStride, int radius) {
+            const __m128 inv = _mm_set1_ps(1.0f / static_cast<float>(2 * radius + 1));
+            __m128i sum = _mm_setzero_si128();
+            for (ptrdiff_t i = -radius; i <= radius; ++i)
+                sum = _mm_add_epi32(sum, widen(edgePixel(src, count, i)));
+
+            for (size_t x = 0; x < count; ++x) {
+                const __m128i out = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), inv));
+                const __m128i packed = _mm_packs_epi32(out, out);
+                dst[x * dstStride] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+
+                sum = _mm_add_epi32(sum, widen(edgePixel(src, count, static_cast<ptrdiff_t>(x) + radius + 1)));
+                sum = _mm_sub_epi32(sum, widen(edgePixel(src, count, static_cast<ptrdiff_t>(x) - radius)));
+            }
+        }
+#endif
+
+#if ANYA_AVX2
+        // the same as the SSE2 kernels, four pixels per 16-bit vector (unpack & pack stay within 128-bit lanes)
+        ANYA_AVX2_TARGET inline __m256i div255(__m256i x) noexcept {
+            return _mm256_mulhi_epu16(_mm256_add_epi16(x, _mm256_set1_epi16(128)), _mm256_set1_epi16(257));
+        }
+
+        ANYA_AVX2_TARGET inline __m256i blend4(__m256i d, __m256i s, __m256i mod) noexcept {
+            const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+            s = div255(_mm256_mullo_epi16(s, mod));
+            const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                                     _MM_SHUFFLE(3, 3, 3, 3));
+            s = _mm256_or_si256(_mm256_andnot_si256(alphaLanes, s),
+                                _mm256_and_si256(alphaLanes, _mm256_set1_epi16(255)));
+
+            const __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+            return div255(_mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, inv)));
+        }
+
+        ANYA_AVX2_TARGET void blendRowAVX2(uint32_t *dst, const uint32_t *src, size_t count, const SDL_Color &mod) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i mod16 = _mm256_set_epi16(mod.a, mod.r, mod.g, mod.b, mod.a, mod.r, mod.g, mod.b, mod.a,
+                                                   mod.r, mod.g, mod.b, mod.a, mod.r, mod.g, mod.b);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_srli_epi32(s, 24), zero)) == -1)
+                    continue;
+
+                const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                const __m256i lo = blend4(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero), mod16);
+                const __m256i hi = blend4(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero), mod16);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(lo, hi));
+            }
+
+            blendRowScalar(dst + i, src + i, count - i, mod);
+        }
+
+        ANYA_AVX2_TARGET inline __m256i blendPremultiplied4(__m256i d, __m256i s, __m256i mod) noexcept {
+            s = div255(_mm256_mullo_epi16(s, mod));
+            const __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)),
+                                                     _MM_SHUFFLE(3, 3, 3, 3));
+            const __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+
+            return _mm256_add_epi16(s, div255(_mm256_mullo_epi16(d, inv)));
+        }
+
+        ANYA_AVX2_TARGET void blendPremultipliedRowAVX2(uint32_t *dst, const uint32_t *src, size_t count,
+                                                        const SDL_Color &mod) {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i mod16 = _mm256_set_epi16(mod.a, mod.r, mod.g, mod.b, mod.a, mod.r, mod.g, mod.b, mod.a,
+                                                   mod.r, mod.g, mod.b, mod.a, mod.r, mod.g, mod.b);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero)) == -1)
+                    continue;
+
+                const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                const __m256i lo =
+                    blendPremultiplied4(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero), mod16);
+                const __m256i hi =
+                    blendPremultiplied4(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero), mod16);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(lo, hi));
+            }
+
+            blendPremultipliedRowScalar(dst + i, src + i, count - i, mod);
+        }
+
+        ANYA_AVX2_TARGET void fillRowAVX2(uint32_t *dst, size_t count, const SDL_Color &col) {
+            const __m256i zero = _mm256_setzero_si256();
+            const int a = col.a;
+            const auto r = static_cast<short>(col.r * a);
+            const auto g = static_cast<short>(col.g * a);
+            const auto b = static_cast<short>(col.b * a);
+            const auto alpha = static_cast<short>(255 * a);
+            const __m256i sa = _mm256_set_epi16(alpha, r, g, b, alpha, r, g, b, alpha, r, g, b, alpha, r, g, b);
+            const __m256i inv = _mm256_set1_epi16(static_cast<short>(255 - a));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+                const __m256i lo =
+                    div255(_mm256_add_epi16(sa, _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv)));
+                const __m256i hi =
+                    div255(_mm256_add_epi16(sa, _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_packus_epi16(lo, hi));
+            }
+
+            fillRowScalar(dst + i, count - i, col);
+        }
+
+        ANYA_AVX2_TARGET inline __m256i premultiply4(__m256i p) noexcept {
+            const __m256i alphaLanes = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+            __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(p, _MM_SHUFFLE(3, 3, 3, 3)),
+                                               _MM_SHUFFLE(3, 3, 3, 3));
+            a = _mm256_or_si256(_mm256_andnot_si256(alphaLanes, a),
+                                _mm256_and_si256(alphaLanes, _mm256_set1_epi16(255)));
+
+            return div255(_mm256_mullo_epi16(p, a));
+        }
+
+        ANYA_AVX2_TARGET void premultiplyRowAVX2(uint32_t *pixels, size_t count) {
+            const __m256i zero = _mm256_setzero_si256();
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                auto *ptr = reinterpret_cast<__m256i *>(pixels + i);
+                const __m256i p = _mm256_loadu_si256(ptr);
+                _mm256_storeu_si256(ptr, _mm256_packus_epi16(premultiply4(_mm256_unpacklo_epi8(p, zero)),
+                                                             premultiply4(_mm256_unpackhi_epi8(p, zero))));
+            }
+
+            premultiplyRowScalar(pixels + i, count - i);
+        }
+
+        ANYA_AVX2_TARGET void colorKeyRowAVX2(uint32_t *pixels, size_t count, uint32_t key, uint32_t tolerance) {
+            const __m256i keyColor = _mm256_set1_epi32(static_cast<int>(key & 0xFFFFFF));
+            const __m256i rgbMask = _mm256_set1_epi32(0xFFFFFF);
+            const __m256i byteMask = _mm256_set1_epi32(0xFF);
+            const __m256i limit = _mm256_set1_epi32(static_cast<int>(tolerance + 1));
+            const __m256i reciprocal = _mm256_set1_epi32(static_cast<int>(keyReciprocal(tolerance)));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                auto *ptr = reinterpret_cast<__m256i *>(pixels + i);
+                const __m256i p = _mm256_loadu_si256(ptr);
+
+                const __m256i diff = _mm256_and_si256(
+                    _mm256_or_si256(_mm256_subs_epu8(p, keyColor), _mm256_subs_epu8(keyColor, p)), rgbMask);
+                const __m256i d = _mm256_and_si256(
+                    _mm256_max_epu8(_mm256_max_epu8(diff, _mm256_srli_epi32(diff, 8)), _mm256_srli_epi32(diff, 16)),
+                    byteMask);
+
+                const __m256i scale = _mm256_min_epi16(d, limit);
+                const __m256i a = _mm256_srli_epi32(p, 24);
+                const __m256i ramp = _mm256_mulhi_epu16(_mm256_mullo_epi16(a, scale), reciprocal);
+                const __m256i full = _mm256_cmpeq_epi32(scale, limit);
+                const __m256i alpha = _mm256_or_si256(_mm256_and_si256(full, a), _mm256_andnot_si256(full, ramp));
+
+                _mm256_storeu_si256(ptr, _mm256_or_si256(_mm256_and_si256(p, rgbMask), _mm256_slli_epi32(alpha, 24)));
+            }
+
+            colorKeyRowScalar(pixels + i, count - i, key, tolerance);
+        }
+#endif
+
+        const Kernels &getKernels(Kernel kernel) noexcept {
+            static constexpr Kernels scalar {blendRowScalar, blendPremultipliedRowScalar, fillRowScalar,
+                                              premultiplyRowScalar, colorKeyRowScalar, blurRowScalar};
+#if ANYA_SSE2
+            static constexpr Kernels sse2 {blendRowSSE2, blendPremultipliedRowSSE2, fillRowSSE2, premultiplyRowSSE2,
+                                            colorKeyRowSSE2, blurRowSSE2};
+            if (kernel == Kernel::SSE2)
+                return sse2;
+#endif
+#if ANYA_AVX2
+            static constexpr Kernels avx2 {blendRowAVX2, blendPremultipliedRowAVX2, fillRowAVX2, premultiplyRowAVX2,
+                                            colorKeyRowAVX2, blurRowSSE2};
+            if (kernel == Kernel::AVX2)
+                return avx2;
+#endif
+            return scalar;
+        }
+    } // namespace
+
+    SDL_Color premultiplyMod(const SDL_Color &mod) noexcept {
+        return {static_cast<uint8_t>(div255(mod.r * mod.a)), static_cast<uint8_t>(div255(mod.g * mod.a)),
+                static_cast<uint8_t>(div255(mod.b * mod.a)), mod.a};
+    }
+
+    void premultiplyAlpha(uint32_t *pixels, size_t count, Kernel kernel) noexcept {
+        if (!Compositor::isSupported(kernel))
+            kernel = Compositor::getBestKernel();
+
+        getKernels(kernel).premultiplyRow(pixels, count);
+    }
+
+    void colorKeyToAlpha(uint32_t *pixels, size_t count, const SDL_Color &key, uint8_t tolerance,
+                         Kernel kernel) noexcept {
+        if (!Compositor::isSupported(kernel))
+            kernel = Compositor::getBestKernel();
+
+        const uint32_t keyColor = (static_cast<uint32_t>(key.r) << 16) | (key.g << 8) | key.b;
+        getKernels(kernel).colorKeyRow(pixels, count, keyColor, tolerance);
+    }
+
+    void boxBlur(uint32_t *pixels, int w, int h, int radius, int passes, Kernel kernel) {
+        if (w <= 0 || h <= 0 || radius <= 0)
+            return;
+
+        if (!Compositor::isSupported(kernel))
+            kernel = Compositor::getBestKernel();
+
+        const BlurRow blurRow = getKernels(kernel).blurRow;
+        const auto width = static_cast<size_t>(w);
+        const auto height = static_cast<size_t>(h);
+        std::vector<uint32_t> columns(width * height);
+        for (int pass = 0; pass < passes; ++pass) {
+            // rows into columns & back, both passes read along a row
+            for (size_t y = 0; y < height; ++y)
+                blurRow(pixels + y * width, width, columns.data() + y, height, radius);
+            for (size_t x = 0; x < width; ++x)
+                blurRow(columns.data() + x * height, height, pixels + x, width, radius);
+        }
+    }
+
+    int Compositor::toLayer(SDL_Surface *surf, Layer &layer) {
+        SDL_Surface *converted = (surf != nullptr) ? SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0)
+                                                   : nullptr;
+        if (converted == nullptr) {
+            panicln("Failed to create layer");
+            return -1;
+        }
+
+        layer.w = converted->w;
+        layer.h = converted->h;
+        layer.pixels.resize(static_cast<size_t>(layer.w) * layer.h);
+        for (int y = 0; y < layer.h; ++y) {
+            std::memcpy(layer.pixels.data() + static_cast<size_t>(y) * layer.w,
+                        static_cast<const uint8_t *>(converted->pixels) + static_cast<size_t>(y) * converted->pitch,
+                        static_cast<size_t>(layer.w) * 4);
+        }
+        SDL_FreeSurface(converted);
+
+        layer.opaque = std::all_of(layer.pixels.begin(), layer.pixels.end(),
+                                   [](uint32_t pixel) { return (pixel >> 24) == 0xFF; });
+        layer.premultiplied = false;
+
+        return 0;
+    }
+
+    int Compositor::readLayer(SDL_Texture *texture, SDL_Renderer *ren, Layer &layer) {
+        uint32_t format = 0;
+        int access = 0;
+        int w = 0;
+        int h = 0;
+        if (texture == nullptr || SDL_QueryTexture(texture, &format, &access, &w, &h) != 0) {
+            panicln("Failed to read layer");
+            return -1;
+        }
+
+        // the built-in modes draw straight alpha, a custom one is Image's premultiplied blend
+        SDL_BlendMode mode = SDL_BLENDMODE_NONE;
+        SDL_GetTextureBlendMode(texture, &mode);
+        const bool premultiplied = mode != SDL_BLENDMODE_NONE && mode != SDL_BLENDMODE_BLEND &&
+                                   mode != SDL_BLENDMODE_ADD && mode != SDL_BLENDMODE_MOD && mode != SDL_BLENDMODE_MUL;
+
+        // a texture that is not a render target is copied into one as it is (no blending or modulation)
+        SDL_Texture *previous = SDL_GetRenderTarget(ren);
+        SDL_Texture *copy = nullptr;
+        if (access != SDL_TEXTUREACCESS_TARGET) {
+            copy = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+            if (copy == nullptr || SDL_SetRenderTarget(ren, copy) != 0) {
+                SDL_DestroyTexture(copy);
+                panicln("Failed to read layer");
+                return -1;
+            }
+
+            SDL_Color mod {255, 255, 255, 255};
+            SDL_GetTextureColorMod(texture, &mod.r, &mod.g, &mod.b);
+            SDL_GetTextureAlphaMod(texture, &mod.a);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+            SDL_SetTextureColorMod(texture, 255, 255, 255);
+            SDL_SetTextureAlphaMod(texture, 255);
+            SDL_RenderCopy(ren, texture, nullptr, nullptr);
+            SDL_SetTextureBlendMode(texture, mode);
+            SDL_SetTextureColorMod(texture, mod.r, mod.g, mod.b);
+            SDL_SetTextureAlphaMod(texture, mod.a);
+        } else if (SDL_SetRenderTarget(ren, texture) != 0) {
+            panicln("Failed to read layer");
+            return -1;
+        }
+
+        layer.w = w;
+        layer.h = h;
+        layer.pixels.resize(static_cast<size_t>(w) * h);
+        const int read = SDL_RenderReadPixels(ren, nullptr, SDL_PIXELFORMAT_ARGB8888, layer.pixels.data(), w * 4);
+        SDL_SetRenderTarget(ren, previous);
+        if (copy != nullptr)
+            SDL_DestroyTexture(copy);
+        if (read != 0) {
+            layer = {};
+            panicln("Failed to read layer");
+            return -1;
+        }
+
+        layer.opaque = std::all_of(layer.pixels.begin(), layer.pixels.end(),
+                                   [](uint32_t pixel) { return (pixel >> 24) == 0xFF; });
+        layer.premultiplied = premultiplied;
+
+        return 0;
+    }
+
+    Kernel Compositor::getBestKernel() noexcept {
+        if (isSupported(Kernel::AVX2))
+            return Kernel::AVX2;
+
+        return isSupported(Kernel::SSE2) ? Kernel::SSE2 : Kernel::Scalar;
+    }
+
+    bool Compositor::isSupported(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::SSE2:
+                return ANYA_SSE2 != 0;
+            case Kernel::AVX2:
+                return cpuHasAvx2();
+            default:
+                return true;
+        }
+    }
+
+    const char *Compositor::getKernelName(Kernel kernel) noexcept {
+        switch (kernel) {
+            case Kernel::SSE2:
+                return "sse2";
+            case Kernel::AVX2:
+                return "avx2";
+            default:
+                return "scalar";
+        }
+    }
+
+    void Compositor::setKernel(Kernel kernel) noexcept {
+        if (isSupported(kernel))
+            this->kernel = kernel;
+    }
+
+    Kernel Compositor::getKernel() const noexcept {
+        return kernel;
+    }
+
+    int Compositor::create(SDL_Renderer *ren, int w, int h) {
+        texture = cheesecake(SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h));
+        if (texture == nullptr) {
+            panicln("Failed to create compositor");
+            return -1;
+        }
+
+        // the frame replaces everything under it
+        SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_NONE);
+        width = w;
+        height = h;
+        frame.assign(static_cast<size_t>(w) * h, 0xFF000000u);
+        dirty = true;
+
+        return 0;
+    }
+
+    void Compositor::clear(const SDL_Color &col) noexcept {
+        const uint32_t pixel = (static_cast<uint32_t>(col.a) << 24) | (col.r << 16) | (col.g << 8) | col.b;
+        std::fill(frame.begin(), frame.end(), pixel);
+        dirty = true;
+    }
+
+    bool Compositor::clipRect(SDL_Rect &dst, SDL_Point &src) const noexcept {
+        if (dst.x < 0) {
+            src.x -= dst.x;
+            dst.w += dst.x;
+            dst.x = 0;
+        }
+
+        if (dst.y < 0) {
+            src.y -= dst.y;
+            dst.h += dst.y;
+            dst.y = 0;
+        }
+
+        dst.w = std::min(dst.w, width - dst.x);
+        dst.h = std::min(dst.h, height - dst.y);
+
+        return dst.w > 0 && dst.h > 0;
+    }
+
+    void Compositor::copy(const Layer &layer, int x, int y) noexcept {
+        SDL_Rect dst {x, y, layer.w, layer.h};
+        SDL_Point src {0, 0};
+        if (!clipRect(dst, src))
+            return;
+
+        dirty = true;
+        for (int row = 0; row < dst.h; ++row) {
+            std::copy_n(layer.pixels.data() + static_cast<size_t>(src.y + row) * layer.w + src.x, dst.w,
+                        frame.data() + static_cast<size_t>(dst.y + row) * width + dst.x);
+        }
+    }
+
+    void Compositor::blend(const Layer &layer, const SDL_Rect *clip, int x, int y, const SDL_Color &mod) noexcept {
+        const SDL_Rect bounds {0, 0, layer.w, layer.h};
+        SDL_Rect area = bounds;
+        if (clip != nullptr && !SDL_IntersectRect(clip, &bounds, &area))
+            return;
+
+        SDL_Rect dst {x, y, area.w, area.h};
+        SDL_Point src {area.x, area.y};
+        if (mod.a == 0 || !clipRect(dst, src))
+            return;
+
+        dirty = true;
+        // an opaque layer without modulation covers what is under it (the background)
+        const bool cover = layer.opaque && mod.r == 255 && mod.g == 255 && mod.b == 255 && mod.a == 255;
+        const Kernels &kernels = getKernels(kernel);
+        const BlendRow blendRow = layer.premultiplied ? kernels.blendPremultipliedRow : kernels.blendRow;
+        for (int line = 0; line < dst.h; ++line) {
+            uint32_t *out = frame.data() + static_cast<size_t>(dst.y + line) * width + dst.x;
+            const uint32_t *in = layer.pixels.data() + static_cast<size_t>(src.y + line) * layer.w + src.x;
+            if (cover)
+                std::copy_n(in, dst.w, out);
+            else
+                blendRow(out, in, static_cast<size_t>(dst.w), mod);
+        }
+    }
+
+    void Compositor::blendScaled(const Layer &layer, const SDL_Rect *clip, const SDL_Rect &dst,
+                                 const SDL_Color &mod) {
+        const SDL_Rect bounds {0, 0, layer.w, layer.h};
+        SDL_Rect area = bounds;
+        if (clip != nullptr && !SDL_IntersectRect(clip, &bounds, &area))
+            return;
+
+        if (dst.w == area.w && dst.h == area.h) {
+            blend(layer, &area, dst.x, dst.y, mod);
+            return;
+        }
+
+        // skip is how far the left & top edges were clipped off the frame
+        SDL_Rect out = dst;
+        SDL_Point skip {0, 0};
+        if (mod.a == 0 || dst.w <= 0 || dst.h <= 0 || !clipRect(out, skip))
+            return;
+
+        dirty = true;
+        const bool cover = layer.opaque && mod.r == 255 && mod.g == 255 && mod.b == 255 && mod.a == 255;
+        const Kernels &kernels = getKernels(kernel);
+        const BlendRow blendRow = layer.premultiplied ? kernels.blendPremultipliedRow : kernels.blendRow;
+        // the same 16.16 steps as SDL's scaled blits, starting in the middle of the first pixel
+        const int64_t stepX = (static_cast<int64_t>(area.w) << 16) / dst.w;
+        const int64_t stepY = (static_cast<int64_t>(area.h) << 16) / dst.h;
+        row.resize(static_cast<size_t>(out.w));
+        for (int line = 0; line < out.h; ++line) {
+            const int64_t y = (stepY / 2 + (skip.y + line) * stepY) >> 16;
+            const uint32_t *in = layer.pixels.data() + static_cast<size_t>(area.y + y) * layer.w + area.x;
+            for (int i = 0; i < out.w; ++i)
+                row[i] = in[(stepX / 2 + (skip.x + i) * stepX) >> 16];
+
+            uint32_t *target = frame.data() + static_cast<size_t>(out.y + line) * width + out.x;
+            if (cover)
+                std::copy(row.begin(), row.end(), target);
+            else
+                blendRow(target, row.data(), row.size(), mod);
+        }
+    }
+
+    void Compositor::fillRect(const SDL_Rect &rect, const SDL_Color &col) noexcept {
+        SDL_Rect dst = rect;
+        SDL_Point src {0, 0};
+        if (col.a == 0 || !clipRect(dst, src))
+            return;
+
+        dirty = true;
+        const uint32_t pixel = (0xFFu << 24) | (col.r << 16) | (col.g << 8) | col.b;
+        const FillRow fillRow = getKernels(kernel).fillRow;
+        for (int row = 0; row < dst.h; ++row) {
+            uint32_t *line = frame.data() + static_cast<size_t>(dst.y + row) * width + dst.x;
+            // an opaque fill is a plain copy
+            if (col.a == SDL_ALPHA_OPAQUE)
+                std::fill_n(line, dst.w, pixel);
+            else
+                fillRow(line, static_cast<size_t>(dst.w), col);
+        }
+    }
+
+    int Compositor::present(SDL_Renderer *ren, const SDL_Rect *dst) {
+        if (texture == nullptr || (dirty && SDL_UpdateTexture(texture.get(), nullptr, frame.data(), width * 4) != 0) ||
+            SDL_RenderCopy(ren, texture.get(), nullptr, dst) != 0) {
+            panicln("Failed to present the frame");
+            return -1;
+        }
+        dirty = false;
+
+        return 0;
+    }
+
+    const uint32_t *Compositor::getPixels() const noexcept {
+        return frame.data();
+    }
+
+    SDL_Point Compositor::getSize() const noexcept {
+        return {width, height};
+    }
+} // namespace Application::Helper
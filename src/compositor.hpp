@@ -0,0 +1,195 @@
+#pragma once
+
+#include <SDL.h>
+#include "data.hpp"
+#include "util.hpp"
+#include <cstdint>
+#include <vector>
+
+/** Structure
+ *
+ * Compositor -> draws layers into one ARGB8888 frame on the CPU & presents it through one streaming texture, for
+ *               the software renderer where every SDL_RenderCopy goes through SDL's generic blitters
+ * Layer -> the pixels of an image kept on the CPU (ARGB8888, straight or premultiplied alpha), an opaque one is
+ *          copied instead of blended when it is drawn without modulation
+ * Scale -> a layer drawn at another size samples the nearest pixel (the steps of SDL's scaled blits) into a row &
+ *          blends that row with the same kernels
+ * Kernel -> scalar, SSE2 (4 pixels) & AVX2 (8 pixels) versions of every row operation, the best one the CPU supports
+ *           is picked at runtime; they all give the same pixels
+ * Blend -> the SDL_BLENDMODE_BLEND equation with colour & alpha modulation, every product rounded to nearest; a
+ *          premultiplied layer is one + dst * (1 - alpha) (Image's custom blend mode), which saves the source product
+ * Premultiply -> the colour of a pixel times its alpha, done once when a surface is loaded (Image)
+ * Colour key -> the key colour becomes alpha once when an image is loaded, with an optional soft edge, so the image
+ *               is blitted as a plain alpha texture afterwards
+ * Blur -> separable box blur, a few passes come close to a gaussian (the frosted backdrop of the settings menus)
+ * Present -> the frame is only uploaded again after something was drawn into it
+ */
+
+namespace Application::Helper {
+    enum class Kernel : uint8_t {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    class Compositor final {
+    public:
+        /** Copies the pixels of a surface into a layer.
+         *
+         * \param surf -> the surface to copy (any format, a colour key becomes transparent)
+         * \param layer -> the layer to fill
+         * \return 0 if the operation succeeded, otherwise -1 if the surface could not be converted.
+         */
+        static int toLayer(SDL_Surface *surf, Layer &layer);
+        /** Reads the pixels of a texture back into a layer, for a texture that has none (slow, a render target copy
+         *  & a readback). The render target is restored afterwards, a texture with a custom blend mode is taken as
+         *  premultiplied.
+         *
+         * \param texture -> the texture to read
+         * \param ren -> the renderer the texture belongs to
+         * \param layer -> the layer to fill
+         * \return 0 if the operation succeeded, otherwise -1 if the texture could not be read.
+         */
+        static int readLayer(SDL_Texture *texture, SDL_Renderer *ren, Layer &layer);
+        /** Gets the fastest kernel the CPU supports.
+         *
+         * \return AVX2, SSE2 or Scalar.
+         */
+        static Kernel getBestKernel() noexcept;
+        /** Checks if a kernel can run on this CPU (and was compiled in).
+         *
+         * \param kernel -> the kernel to check
+         * \return true if supported, otherwise false.
+         */
+        static bool isSupported(Kernel kernel) noexcept;
+        /** Gets the name of a kernel.
+         *
+         * \param kernel -> the kernel
+         * \return "scalar", "sse2" or "avx2".
+         */
+        static const char *getKernelName(Kernel kernel) noexcept;
+        /** Picks the kernel for the row operations (for comparing them), an unsupported one is ignored.
+         *
+         * \param kernel -> the kernel to use
+         */
+        void setKernel(Kernel kernel) noexcept;
+        /** Gets the kernel used for the row operations.
+         *
+         * \return the kernel.
+         */
+        Kernel getKernel() const noexcept;
+        /** Creates the frame & the streaming texture it is presented through.
+         *
+         * \param ren -> the renderer to use
+         * \param w -> the width of the frame
+         * \param h -> the height of the frame
+         * \return 0 if the operation succeeded, otherwise -1 if the texture failed to be created.
+         */
+        int create(SDL_Renderer *ren, int w, int h);
+        /** Fills the whole frame with a colour (no blending).
+         *
+         * \param col -> the colour of the frame
+         */
+        void clear(const SDL_Color &col) noexcept;
+        /** Copies an opaque layer into the frame (no blending, like SDL_BLENDMODE_NONE).
+         *
+         * \param layer -> the layer to copy
+         * \param x -> x position of the layer
+         * \param y -> y position of the layer
+         */
+        void copy(const Layer &layer, int x, int y) noexcept;
+        /** Blends a layer into the frame.
+         *
+         * \param layer -> the layer to blend
+         * \param clip -> the part of the layer to blend (nullptr for the whole layer)
+         * \param x -> x position of the layer
+         * \param y -> y position of the layer
+         * \param mod -> the colour & alpha modulation (white for none)
+         */
+        void blend(const Layer &layer, const SDL_Rect *clip, int x, int y, const SDL_Color &mod) noexcept;
+        /** Blends a layer into the frame at another size (nearest pixel), at the same size it is a plain blend.
+         *
+         * \param layer -> the layer to blend
+         * \param clip -> the part of the layer to blend (nullptr for the whole layer)
+         * \param dst -> where the part is stretched to
+         * \param mod -> the colour & alpha modulation (white for none)
+         */
+        void blendScaled(const Layer &layer, const SDL_Rect *clip, const SDL_Rect &dst, const SDL_Color &mod);
+        /** Blends a filled rectangle into the frame.
+         *
+         * \param rect -> the area to fill
+         * \param col -> colour of the rectangle (the alpha is the opacity)
+         */
+        void fillRect(const SDL_Rect &rect, const SDL_Color &col) noexcept;
+        /** Uploads the frame (if it changed since the last present) & copies it to the render target.
+         *
+         * \param ren -> the renderer to use
+         * \param dst -> (optional) where to copy the frame, the whole render target by default
+         * \return 0 if the operation succeeded, otherwise -1 if the frame failed to be uploaded.
+         */
+        int present(SDL_Renderer *ren, const SDL_Rect *dst = nullptr);
+        /** Gets the pixels of the frame.
+         *
+         * \return the frame (ARGB8888, width * height pixels).
+         */
+        const uint32_t *getPixels() const noexcept;
+        /** Gets the size of the frame.
+         *
+         * \return the width (x) and height (y) of the frame.
+         */
+        SDL_Point getSize() const noexcept;
+
+    private:
+        // clips dst to the frame and moves src by the same amount, false if nothing is left
+        bool clipRect(SDL_Rect &dst, SDL_Point &src) const noexcept;
+
+    private:
+        std::vector<uint32_t> frame {};
+        int width {0};
+        int height {0};
+        Utils::SMD<SDL_Texture> texture {nullptr};
+        Kernel kernel {getBestKernel()};
+        // drawn into since the last upload
+        bool dirty {true};
+        // a stretched source row
+        std::vector<uint32_t> row {};
+    };
+
+    /** Multiplies a colour modulation by its alpha, for drawing a premultiplied texture or layer (the alpha
+     *  modulation has to scale the colour that was multiplied by alpha already).
+     *
+     * \param mod -> the colour & alpha modulation
+     * \return the modulation with its colour scaled by its alpha.
+     */
+    SDL_Color premultiplyMod(const SDL_Color &mod) noexcept;
+    /** Multiplies the colour of ARGB8888 pixels by their alpha, in place.
+     *
+     * \param pixels -> the pixels to convert
+     * \param count -> the number of pixels
+     * \param kernel -> (optional) the kernel to use, the best one by default (an unsupported one is ignored)
+     */
+    void premultiplyAlpha(uint32_t *pixels, size_t count, Kernel kernel = Compositor::getBestKernel()) noexcept;
+    /** Makes the pixels of a colour transparent, in place. The alpha ramps up from 0 at the key to the pixel's own
+     *  alpha once the largest channel difference to the key is over the tolerance.
+     *
+     * \param pixels -> the pixels to convert (ARGB8888)
+     * \param count -> the number of pixels
+     * \param key -> the colour to remove (its alpha is ignored)
+     * \param tolerance -> the channel difference that is still (partly) removed, 0 for the exact colour only
+     * \param kernel -> (optional) the kernel to use, the best one by default (an unsupported one is ignored)
+     */
+    void colorKeyToAlpha(uint32_t *pixels, size_t count, const SDL_Color &key, uint8_t tolerance,
+                         Kernel kernel = Compositor::getBestKernel()) noexcept;
+    /** Blurs ARGB8888 pixels in place with a box filter (edges are repeated), every pass blurs the rows & then the
+     *  columns. Three passes look close to a gaussian blur.
+     *
+     * \param pixels -> the pixels to blur (w * h, no padding)
+     * \param w -> the width of the image
+     * \param h -> the height of the image
+     * \param radius -> the box is 2 * radius + 1 pixels wide
+     * \param passes -> (optional) the number of passes
+     * \param kernel -> (optional) the kernel to use, the best one by default (AVX2 runs the SSE2 blur)
+     */
+    void boxBlur(uint32_t *pixels, int w, int h, int radius, int passes = 3,
+                 Kernel kernel = Compositor::getBestKernel());
+} // namespace Application::Helper
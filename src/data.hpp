@@ -1,10 +1,28 @@
 #pragma once
 
 #include <SDL.h>
+#include "util.hpp"
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace Application::Helper {
+    // Index of a scene (layer) registered with Scene
+    using SceneID = uint32_t;
+    // Scene that is never registered, used for "no scene"
+    inline constexpr SceneID noScene = UINT32_MAX;
+
+    // Subsystem memory is charged to (memory.hpp)
+    enum class MemTag : uint8_t {
+        Other,
+        Image,
+        Animation,
+        Interface,
+        Text,
+        Count,
+    };
+
     struct ColorData final {
         SDL_Color outlineColor {55, 55, 55};
         SDL_Color bgColor {255, 255, 255};
@@ -19,20 +37,63 @@ namespace Application::Helper {
         int outlineThickness {1};
     };
 
+    /** Generational handle to an image in the Registry (32 bits).
+     *
+     *  low 20 bits -> slot index
+     *  high 12 bits -> slot generation, a released slot bumps it so old handles stop resolving
+     *
+     *  a default constructed handle (0) never refers to an image.
+     */
+    struct ImageHandle final {
+        uint32_t id {0};
+
+        constexpr uint32_t index() const noexcept { return id & 0xFFFFF; }
+        constexpr uint32_t generation() const noexcept { return id >> 20; }
+        constexpr explicit operator bool() const noexcept { return id != 0; }
+        constexpr bool operator==(const ImageHandle &) const noexcept = default;
+    };
+
+    // The pixels of an image kept on the CPU for the Compositor (ARGB8888, straight or premultiplied alpha)
+    struct Layer final {
+        std::vector<uint32_t> pixels {};
+        int w {0};
+        int h {0};
+        // Every pixel has full alpha
+        bool opaque {false};
+        // The colour was multiplied by alpha (blended as one + dst * (1 - alpha))
+        bool premultiplied {false};
+    };
+
     struct ImageData final {
-        // The file path of the image
-        std::basic_string<char> path;
+        // The interned name of the image (file path, pack name or font file)
+        uint32_t name {0};
         // The image itself, self-managed memory
-        std::shared_ptr<SDL_Texture> texture {nullptr};
-        // The width of the image (horizontal)
-        int imageWidth;
-        // The height of the image (vertical)
-        int imageHeight;
+        Utils::SMD<SDL_Texture> texture {nullptr};
+        // A copy of the texture's pixels when Image keeps layers (empty for render targets drawn by SDL)
+        Layer layer {};
+        // The width of the image (horizontal), cached when the texture is set
+        int imageWidth {0};
+        // The height of the image (vertical), cached when the texture is set
+        int imageHeight {0};
         // The image's X position
-        int imagePos1;
+        int imagePos1 {0};
         // The image's Y position
-        int imagePos2;
+        int imagePos2 {0};
+        // The colour & alpha modulation of the image, applied again if the texture is reloaded
+        SDL_Color color {255, 255, 255, 255};
+        // Texture memory the image holds (width * height * bytes per pixel), 0 if not resident
+        size_t textureBytes {0};
+        // CPU memory of the layer (width * height * 4), counted in the texture budget as well
+        size_t layerBytes {0};
+        // When the image was last used (in Image uses)
+        uint64_t lastUse {0};
+        // The scene the image was last used in (in Image scene changes)
+        uint64_t lastScene {0};
+        // Hash of the message a text image was made from, the same message is not rendered again
+        uint64_t textKey {0};
+        // What the texture is for (image, animation atlas or text), used for the memory report
+        MemTag owner {MemTag::Image};
+        // The texture holds premultiplied alpha (drawn with Image's premultiplied blend mode)
+        bool premultiplied {false};
     };
-    // handle
-    using IMD = std::shared_ptr<ImageData>;
 } // namespace Application::Helper
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "diskcache.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <fstream>
+#include <vector>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        constexpr char entryMagic[4] = {'A', 'N', 'Y', 'C'};
+        constexpr uint32_t entryVersion = 1;
+        constexpr std::string_view entryExtension = ".px";
+        // longer stored paths are a corrupt entry, not a path
+        constexpr uint32_t maxPathLength = 4096;
+
+        // stored in front of the pixels, followed by the source path
+        struct EntryHeader final {
+            char magic[4];
+            uint32_t version;
+            uint64_t sourceSize;
+            int64_t sourceTime;
+            uint64_t contentHash;
+            int32_t width;
+            int32_t height;
+            uint32_t pathLength;
+        };
+
+        // hash the source file, this is a plain read and much cheaper than decoding it
+        bool hashFile(const std::filesystem::path &path, uint64_t &hash) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                return false;
+
+            std::vector<char> chunk(64 * 1024);
+            hash = fnv1a(nullptr, 0);
+            while (file) {
+                file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                hash = fnv1a(chunk.data(), static_cast<size_t>(file.gcount()), hash);
+            }
+
+            return true;
+        }
+
+        bool sourceInfo(const std::filesystem::path &path, uint64_t &size, int64_t &time) {
+            std::error_code ec;
+            size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+
+            time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+            return !ec;
+        }
+    } // namespace
+
+    DiskCache::DiskCache() {
+        std::filesystem::path base;
+        if (const char *xdg = SDL_getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0') {
+            base = xdg;
+        } else if (const char *local = SDL_getenv("LOCALAPPDATA"); local != nullptr && *local != '\0') {
+            base = local;
+        } else if (const char *home = SDL_getenv("HOME"); home != nullptr && *home != '\0') {
+            base = std::filesystem::path(home) / ".cache";
+        } else {
+            println("Image cache disabled, no cache directory");
+            return;
+        }
+
+        cacheDir = base / "anya";
+
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDir, ec);
+        enabled = !ec && std::filesystem::is_directory(cacheDir, ec);
+    }
+
+    std::filesystem::path DiskCache::entryPath(std::string_view filePath, const SDL_Point *fit) const {
+        uint64_t key = fnv1a(filePath.data(), filePath.size());
+        if (fit != nullptr)
+            key = fnv1a(fit, sizeof(SDL_Point), key);
+
+        return cacheDir / std::format("{:016x}{}", key, entryExtension);
+    }
+
+    SDL_Surface *DiskCache::load(std::string_view filePath, const SDL_Point *fit) {
+        if (!enabled)
+            return nullptr;
+
+        const std::filesystem::path source(filePath);
+        const std::filesystem::path entry = entryPath(filePath, fit);
+
+        std::ifstream file(entry, std::ios::binary);
+        if (!file)
+            return nullptr;
+
+        EntryHeader header {};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!file || !std::equal(std::begin(entryMagic), std::end(entryMagic), header.magic) ||
+            header.version != entryVersion || header.width <= 0 || header.height <= 0 ||
+            header.pathLength != filePath.size() || header.pathLength > maxPathLength)
+            return nullptr;
+
+        // a corrupt header must not size the surface, the entry holds exactly what it declares
+        std::error_code ec;
+        const uint64_t entryBytes = std::filesystem::file_size(entry, ec);
+        if (ec || entryBytes != sizeof(EntryHeader) + header.pathLength +
+                                    static_cast<uint64_t>(header.width) * static_cast<uint64_t>(header.height) * 4)
+            return nullptr;
+
+        // two paths can share a key, the full path is checked as well
+        std::basic_string<char> storedPath(header.pathLength, '\0');
+        file.read(storedPath.data(), header.pathLength);
+        if (file.gcount() != static_cast<std::streamsize>(header.pathLength) || storedPath != filePath)
+            return nullptr;
+
+        uint64_t size = 0;
+        int64_t time = 0;
+        if (!sourceInfo(source, size, time) || size != header.sourceSize)
+            return nullptr;
+
+        // the content is only read when the file was touched (copied, checked out again) but kept its size
+        uint64_t hash = 0;
+        if (time != header.sourceTime && (!hashFile(source, hash) || hash != header.contentHash))
+            return nullptr;
+
+        SDL_Surface *surf =
+            SDL_CreateRGBSurfaceWithFormat(0, header.width, header.height, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (surf == nullptr) {
+            panicln("Failed to create cached image surface");
+            return nullptr;
+        }
+
+        const auto rowBytes = static_cast<std::streamsize>(header.width) * 4;
+        for (int y = 0; y < header.height && file; ++y)
+            file.read(static_cast<char *>(surf->pixels) + static_cast<ptrdiff_t>(y) * surf->pitch, rowBytes);
+
+        if (!file) {
+            SDL_FreeSurface(surf);
+            return nullptr;
+        }
+        file.close();
+
+        // the content matched, the new mtime is stored so the next launch does not hash the source again
+        if (time != header.sourceTime) {
+            std::fstream stamp(entry, std::ios::binary | std::ios::in | std::ios::out);
+            stamp.seekp(static_cast<std::streamoff>(offsetof(EntryHeader, sourceTime)));
+            stamp.write(reinterpret_cast<const char *>(&time), sizeof(time));
+        }
+
+        // mark the entry as recently used for eviction
+        std::filesystem::last_write_time(entry, std::filesystem::file_time_type::clock::now(), ec);
+
+        return surf;
+    }
+
+    int DiskCache::store(std::string_view filePath, SDL_Surface *surf, const SDL_Point *fit) {
+        if (!enabled || surf == nullptr)
+            return -1;
+
+        EntryHeader header {};
+        std::copy(std::begin(entryMagic), std::end(entryMagic), header.magic);
+        header.version = entryVersion;
+        header.width = surf->w;
+        header.height = surf->h;
+        header.pathLength = static_cast<uint32_t>(filePath.size());
+
+        const std::filesystem::path source(filePath);
+        if (!sourceInfo(source, header.sourceSize, header.sourceTime) || !hashFile(source, header.contentHash))
+            return -1;
+
+        SDL_Surface *pixels = surf;
+        if (surf->format->format != SDL_PIXELFORMAT_ARGB8888) {
+            pixels = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+            if (pixels == nullptr) {
+                panicln("Failed to convert image for caching");
+                return -1;
+            }
+        }
+
+        // write to a temporary file first so a crash never leaves a half written entry
+        const std::filesystem::path entry = entryPath(filePath, fit);
+        std::filesystem::path temp = entry;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(filePath.data(), static_cast<std::streamsize>(filePath.size()));
+
+            const auto rowBytes = static_cast<std::streamsize>(pixels->w) * 4;
+            for (int y = 0; y < pixels->h; ++y)
+                file.write(static_cast<const char *>(pixels->pixels) + static_cast<ptrdiff_t>(y) * pixels->pitch,
+                           rowBytes);
+
+            if (!file) {
+                println("Failed to write image cache entry");
+                file.close();
+                std::error_code ec;
+                std::filesystem::remove(temp, ec);
+                if (pixels != surf)
+                    SDL_FreeSurface(pixels);
+                return -1;
+            }
+        }
+
+        if (pixels != surf)
+            SDL_FreeSurface(pixels);
+
+        std::error_code ec;
+        std::filesystem::rename(temp, entry, ec);
+        if (ec) {
+            std::filesystem::remove(temp, ec);
+            return -1;
+        }
+
+        evict();
+
+        return 0;
+    }
+
+    void DiskCache::evict() {
+        struct Entry {
+            std::filesystem::path path;
+            std::filesystem::file_time_type lastUse;
+            uint64_t size;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t totalBytes = 0;
+
+        std::error_code ec;
+        for (const auto &pathIter : std::filesystem::directory_iterator(cacheDir, ec)) {
+            if (pathIter.path().extension() != entryExtension)
+                continue;
+
+            Entry entry {pathIter.path(), pathIter.last_write_time(ec), pathIter.file_size(ec)};
+            if (ec)
+                continue;
+
+            totalBytes += entry.size;
+            entries.emplace_back(std::move(entry));
+        }
+
+        if (totalBytes <= maxBytes && entries.size() <= maxEntries)
+            return;
+
+        // oldest first
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry &a, const Entry &b) { return a.lastUse < b.lastUse; });
+
+        size_t count = entries.size();
+        for (const auto &entry : entries) {
+            if (totalBytes <= maxBytes && count <= maxEntries)
+                break;
+
+            if (std::filesystem::remove(entry.path, ec)) {
+                totalBytes -= entry.size;
+                --count;
+            }
+        }
+    }
+
+    void DiskCache::setLimits(uint64_t bytes, uint32_t entries) noexcept {
+        maxBytes = bytes;
+        maxEntries = entries;
+    }
+
+    bool DiskCache::isEnabled() const noexcept {
+        return enabled;
+    }
+} // namespace Application::Helper
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+/** Structure
+ *
+ * DiskCache -> persists decoded (and downscaled) image pixels so they can skip the decoder on the next load
+ * Entry -> one file per source path & fit size, valid while the source has the same size & mtime; a source with a
+ *          new mtime is hashed & still valid if its content did not change (the entry then takes the new mtime)
+ */
+
+namespace Application::Helper {
+    class DiskCache final {
+    public:
+        /* DiskCache Constructor; resolves the cache directory ($XDG_CACHE_HOME/anya, ~/.cache/anya or
+         * %LOCALAPPDATA%/anya). The cache is disabled if none of those can be created.
+         */
+        DiskCache();
+        /** Looks up the decoded pixels of an image.
+         *
+         * \param filePath -> the location of the source image file
+         * \param fit -> the size the image was downscaled to cover (nullptr if it was stored at full size)
+         * \return an ARGB8888 surface (caller frees it) or nullptr if there is no valid entry.
+         */
+        SDL_Surface *load(std::string_view filePath, const SDL_Point *fit = nullptr);
+        /** Stores the decoded pixels of an image, evicting the least recently used entries if over the limits.
+         *
+         * \param filePath -> the location of the source image file
+         * \param surf -> the decoded surface (converted to ARGB8888 if needed)
+         * \param fit -> the size the image was downscaled to cover (nullptr if stored at full size)
+         * \return 0 if the operation succeeded, otherwise -1 if it failed.
+         */
+        int store(std::string_view filePath, SDL_Surface *surf, const SDL_Point *fit = nullptr);
+        /** Sets the size limits of the cache.
+         *
+         * \param bytes -> the maximum number of bytes on disk
+         * \param entries -> the maximum number of cached images
+         */
+        void setLimits(uint64_t bytes, uint32_t entries) noexcept;
+        /** Checks if the cache can be used.
+         *
+         * \return true if the cache directory exists, otherwise false.
+         */
+        bool isEnabled() const noexcept;
+
+    private:
+        std::filesystem::path entryPath(std::string_view filePath, const SDL_Point *fit) const;
+        void evict();
+
+    private:
+        std::filesystem::path cacheDir {};
+        uint64_t maxBytes {32ull * 1024 * 1024};
+        uint32_t maxEntries {32};
+        bool enabled {false};
+    };
+} // namespace Application::Helper
@@ -1,6 +1,12 @@
 #include "image.hpp"
+#include "compositor.hpp"
+#include "memory.hpp"
+#include "trace.hpp"
 #include "util.hpp"
+#include <cmath>
+#include <algorithm>
 #include <filesystem>
+#include <format>
 
 using namespace Application::Helper::Utils;
 
@@ -14,127 +20,571 @@ namespace Application::Helper {
         return IMG_Load(filePath.data());
     }
 
-    IMD Image::createImage(std::string_view filePath, SDL_Renderer *ren, SDL_Color *key) {
-        IMD newImage = std::make_shared<ImageData>();
-        newImage->path = filePath;
+    // the registry name of an image, the same file with another fit or key is another image
+    std::basic_string<char> variantName(std::string_view filePath, const SDL_Color *key, const SDL_Point *fit,
+                                        uint8_t keyTolerance) {
+        if (key == nullptr && fit == nullptr)
+            return std::basic_string<char>(filePath);
 
-        auto iter = images.find(filePath.data());
-        if (iter != images.end())
-            return iter->second; // we found the filePath
+        std::basic_string<char> name(filePath);
+        if (fit != nullptr)
+            name += std::format("|fit={}x{}", fit->x, fit->y);
+        if (key != nullptr)
+            name += std::format("|key={:02x}{:02x}{:02x}~{}", key->r, key->g, key->b, keyTolerance);
 
-        SDL_Surface *surf = loadFile(filePath);
+        return name;
+    }
 
-        if (key != nullptr)
-            SDL_SetColorKey(surf, SDL_TRUE, SDL_MapRGB(surf->format, key->r, key->g, key->b));
+    // shrink a surface so it still covers the fit size, the original surface is freed
+    SDL_Surface *downscale(SDL_Surface *surf, const SDL_Point &fit) {
+        const double scale = std::max(static_cast<double>(fit.x) / surf->w, static_cast<double>(fit.y) / surf->h);
+        if (scale >= 1.0)
+            return surf;
 
-        newImage->texture = cheesecake(SDL_CreateTextureFromSurface(ren, surf));
-        if (newImage->texture == nullptr) {
-            panicln("Failed to create image");
+        SDL_Surface *src = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surf);
+        if (src == nullptr)
             return nullptr;
+
+        const int w = std::max(fit.x, static_cast<int>(std::ceil(src->w * scale)));
+        const int h = std::max(fit.y, static_cast<int>(std::ceil(src->h * scale)));
+        SDL_Surface *dst = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (dst == nullptr || SDL_SoftStretchLinear(src, nullptr, dst, nullptr) != 0) {
+            panicln("Failed to downscale image");
+            SDL_FreeSurface(dst);
+            return src;
         }
-        images.insert({filePath.data(), newImage});
+        SDL_FreeSurface(src);
 
-        SDL_FreeSurface(surf);
+        return dst;
+    }
+
+    // the number of bytes a texture takes (width * height * bytes per pixel of its format)
+    size_t textureSize(SDL_Texture *texture) {
+        uint32_t format = 0;
+        int w = 0;
+        int h = 0;
+        if (texture == nullptr || SDL_QueryTexture(texture, &format, nullptr, &w, &h) != 0)
+            return 0;
 
-        return newImage;
+        return static_cast<size_t>(w) * h * SDL_BYTESPERPIXEL(format);
     }
 
-    IMD Image::createRenderTarget(SDL_Renderer *ren, unsigned int width, unsigned int height) {
-        IMD newImage = std::make_shared<ImageData>();
+    SDL_Texture *Image::loadTexture(std::string_view filePath, SDL_Renderer *ren, const SDL_Color *key,
+                                    const SDL_Point *fit, uint8_t keyTolerance, Layer *layer) {
+        // fitted images are decoded once and then read back from the disk cache
+        SDL_Surface *surf = (fit != nullptr) ? diskCache.load(filePath, fit) : nullptr;
+        if (surf == nullptr) {
+            surf = loadFile(filePath);
+            if (surf != nullptr && fit != nullptr) {
+                surf = downscale(surf, *fit);
+                diskCache.store(filePath, surf, fit);
+            }
+        }
 
-        newImage->texture =
-            cheesecake(SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height));
-        if (newImage->texture == nullptr) {
-            panicln("Render Target failed to be created");
+        if (surf == nullptr) {
+            panicln("Failed to load image");
             return nullptr;
         }
 
-        return newImage;
+        if (key != nullptr) {
+            // the key becomes alpha here, every later blit is a plain alpha blit
+            SDL_Surface *converted = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+            if (converted != nullptr && SDL_LockSurface(converted) == 0) {
+                for (int y = 0; y < converted->h; ++y) {
+                    colorKeyToAlpha(reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(converted->pixels) +
+                                                                 static_cast<size_t>(y) * converted->pitch),
+                                    static_cast<size_t>(converted->w), *key, keyTolerance);
+                }
+                SDL_UnlockSurface(converted);
+                SDL_FreeSurface(surf);
+                surf = converted;
+            } else {
+                SDL_FreeSurface(converted);
+                SDL_SetColorKey(surf, SDL_TRUE, SDL_MapRGB(surf->format, key->r, key->g, key->b));
+            }
+        }
+
+        return createTexture(surf, ren, layer);
     }
 
-    IMD Image::createText(const MessageData &msg, SDL_Renderer *ren) {
-        IMD newImage = std::make_shared<ImageData>();
-        newImage->path = msg.fontFile;
+    SDL_Texture *Image::createTexture(SDL_Surface *surf, SDL_Renderer *ren, Layer *layer) {
+        trackSurface(surf, true);
+        // premultiplied on its own, the compositor blends it that way even where the renderer cannot
+        if (keepLayers && layer != nullptr && Compositor::toLayer(surf, *layer) == 0 && premultiplyLayers) {
+            premultiplyAlpha(layer->pixels.data(), layer->pixels.size());
+            layer->premultiplied = true;
+        }
+
+        if (premultiply) {
+            // a colour key becomes alpha here, the surface is then premultiplied in place
+            SDL_Surface *converted = (surf->format->format == SDL_PIXELFORMAT_ARGB8888 && SDL_HasColorKey(surf) == 0)
+                                         ? surf
+                                         : SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_ARGB8888, 0);
+            if (converted != nullptr && SDL_LockSurface(converted) == 0) {
+                for (int y = 0; y < converted->h; ++y) {
+                    premultiplyAlpha(reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(converted->pixels) +
+                                                                  static_cast<size_t>(y) * converted->pitch),
+                                     static_cast<size_t>(converted->w));
+                }
+                SDL_UnlockSurface(converted);
+
+                if (converted != surf) {
+                    trackSurface(surf, false);
+                    SDL_FreeSurface(surf);
+                    surf = converted;
+                    trackSurface(surf, true);
+                }
+
+                SDL_Texture *texture = SDL_CreateTextureFromSurface(ren, surf);
+                if (texture != nullptr)
+                    SDL_SetTextureBlendMode(texture, premultipliedBlend);
+
+                trackSurface(surf, false);
+                SDL_FreeSurface(surf);
+                return texture;
+            }
 
-        TTF_Font *font = TTF_OpenFont(msg.fontFile.data(), msg.fontSize);
-        if (font == nullptr) {
-            panicln("TTF_OpenFont error");
-            return nullptr;
+            // straight alpha is still correct, only slower
+            if (converted != surf)
+                SDL_FreeSurface(converted);
         }
 
-        SDL_Surface *surf = TTF_RenderText_Blended(font, msg.msg.data(), msg.col.textColor);
-        if (surf == nullptr) {
-            TTF_CloseFont(font);
-            panicln("TTF_RenderText error");
-            return nullptr;
+        SDL_Texture *texture = SDL_CreateTextureFromSurface(ren, surf);
+        trackSurface(surf, false);
+        SDL_FreeSurface(surf);
+
+        return texture;
+    }
+
+    ImageHandle Image::createImage(std::string_view filePath, SDL_Renderer *ren, SDL_Color *key,
+                                   const SDL_Point *fit, uint8_t keyTolerance) {
+        MemoryScope scope(MemTag::Image);
+        const std::basic_string<char> name = variantName(filePath, key, fit, keyTolerance);
+        ImageHandle handle = registry.find(name);
+        if (ImageData *found = registry.get(handle); found != nullptr) {
+            // we found the image, bring it back if it was evicted
+            if (found->texture == nullptr && reload(*found, ren) != 0)
+                return {};
+
+            touch(*found);
+            return handle;
         }
 
-        newImage->texture = cheesecake(SDL_CreateTextureFromSurface(ren, surf));
-        if (newImage->texture == nullptr) {
-            panicln("Failed to create text image");
-            return nullptr;
+        Layer layer {};
+        SDL_Texture *texture = loadTexture(filePath, ren, key, fit, keyTolerance, &layer);
+        if (texture == nullptr) {
+            panicln("Failed to create image");
+            return {};
         }
-        images.insert({msg.fontFile, newImage});
 
-        SDL_FreeSurface(surf);
-        TTF_CloseFont(font);
+        handle = registry.create(name);
+        ImageData *newImage = registry.get(handle);
+        if (newImage == nullptr) {
+            SDL_DestroyTexture(texture);
+            return {};
+        }
+        setTexture(*newImage, texture, std::move(layer));
+
+        reloadList.insert_or_assign(newImage->name, makeReloadData(filePath, key, fit, keyTolerance));
 
-        return newImage;
+        touch(*newImage);
+        trim();
+
+        return handle;
     }
 
-    IMD Image::createTextA(const MessageData &msg, SDL_Renderer *ren) {
-        IMD newImage = std::make_shared<ImageData>();
+    ImageHandle Image::declareImage(std::string_view filePath, const SDL_Color *key, const SDL_Point *fit,
+                                    uint8_t keyTolerance) {
+        MemoryScope scope(MemTag::Image);
+        const std::basic_string<char> name = variantName(filePath, key, fit, keyTolerance);
+        ImageHandle handle = registry.find(name);
+        if (registry.get(handle) != nullptr)
+            return handle;
 
-        TTF_Font *font = TTF_OpenFont(msg.fontFile.data(), msg.fontSize);
-        if (font == nullptr) {
-            panicln("TTF_OpenFont error");
+        handle = registry.create(name);
+        ImageData *newImage = registry.get(handle);
+        if (newImage == nullptr)
+            return {};
+
+        // no texture yet, the reload data is all it takes to load it
+        reloadList.insert_or_assign(newImage->name, makeReloadData(filePath, key, fit, keyTolerance));
+
+        return handle;
+    }
+
+    int Image::loadImages(std::span<const ImageHandle> images, SDL_Renderer *ren) {
+        int result = 0;
+        for (const ImageHandle handle : images) {
+            ImageData *img = registry.get(handle);
+            if (img == nullptr || (img->texture == nullptr && reload(*img, ren) != 0)) {
+                result = -1;
+                continue;
+            }
+
+            touch(*img);
+        }
+
+        return result;
+    }
+
+    void Image::releaseImages(std::span<const ImageHandle> images) noexcept {
+        for (const ImageHandle handle : images) {
+            ImageData *img = registry.get(handle);
+            if (img == nullptr || img->texture == nullptr || !reloadList.contains(img->name))
+                continue;
+
+            untrack(*img);
+            img->texture = nullptr;
+        }
+    }
+
+    int Image::reload(ImageData &img, SDL_Renderer *ren) {
+        const auto iter = reloadList.find(img.name);
+        if (iter == reloadList.end()) {
+            println("Failed to reload image");
+            return -1;
+        }
+
+        const ReloadData &reloadData = iter->second;
+        Layer layer {};
+        SDL_Texture *texture = loadTexture(reloadData.filePath, ren, reloadData.key ? &*reloadData.key : nullptr,
+                                           reloadData.fit ? &*reloadData.fit : nullptr, reloadData.keyTolerance,
+                                           &layer);
+        if (texture == nullptr) {
+            panicln("Failed to reload image");
+            return -1;
+        }
+
+        setTexture(img, texture, std::move(layer));
+        touch(img);
+        trim();
+
+        return 0;
+    }
+
+    Image::ReloadData Image::makeReloadData(std::string_view filePath, const SDL_Color *key, const SDL_Point *fit,
+                                            uint8_t keyTolerance) {
+        ReloadData reloadData {std::basic_string<char>(filePath)};
+        if (key != nullptr)
+            reloadData.key = *key;
+        reloadData.keyTolerance = keyTolerance;
+        if (fit != nullptr)
+            reloadData.fit = *fit;
+
+        return reloadData;
+    }
+
+    void Image::setTexture(ImageData &img, SDL_Texture *texture, Layer &&layer) noexcept {
+        untrack(img);
+        img.texture = cheesecake(texture);
+        img.layer = std::move(layer);
+        // cache the size so drawing never has to query the texture
+        SDL_QueryTexture(texture, nullptr, nullptr, &img.imageWidth, &img.imageHeight);
+
+        SDL_BlendMode mode = SDL_BLENDMODE_NONE;
+        img.premultiplied = SDL_GetTextureBlendMode(texture, &mode) == 0 && mode == premultipliedBlend;
+        if (img.color.r != 255 || img.color.g != 255 || img.color.b != 255 || img.color.a != SDL_ALPHA_OPAQUE)
+            applyColor(img);
+
+        track(img);
+    }
+
+    const Layer *Image::findLayer(ImageData &img, SDL_Renderer *ren) noexcept {
+        if (!img.layer.pixels.empty())
+            return &img.layer;
+
+        if (drawTarget == nullptr || ren == nullptr || img.texture == nullptr)
             return nullptr;
+
+        // drawn through the renderer it would be covered by the compositor's frame, it is read back once instead
+        println("Image has no layer, reading it back from its texture");
+        Layer layer {};
+        if (Compositor::readLayer(img.texture.get(), ren, layer) != 0)
+            return nullptr;
+        img.layer = std::move(layer);
+        img.layerBytes = img.layer.pixels.size() * sizeof(uint32_t);
+        layerBytes += img.layerBytes;
+
+        return &img.layer;
+    }
+
+    void Image::applyColor(const ImageData &img) noexcept {
+        const SDL_Color mod = img.premultiplied ? premultiplyMod(img.color) : img.color;
+
+        SDL_SetTextureColorMod(img.texture.get(), mod.r, mod.g, mod.b);
+        SDL_SetTextureAlphaMod(img.texture.get(), mod.a);
+    }
+
+    int Image::setPremultipliedAlpha(SDL_Renderer *ren, bool enable) {
+        // the layers do not depend on the renderer
+        premultiplyLayers = enable;
+        if (!enable) {
+            premultiply = false;
+            return 0;
+        }
+
+        // the software renderer only has the built-in blend modes
+        SDL_Texture *probe = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+        const bool supported = probe != nullptr && SDL_SetTextureBlendMode(probe, premultipliedBlend) == 0;
+        SDL_DestroyTexture(probe);
+        if (!supported) {
+            println("Premultiplied alpha is not supported by the renderer");
+            premultiply = false;
+            return -1;
+        }
+
+        premultiply = true;
+
+        return 0;
+    }
+
+    void Image::track(ImageData &img) noexcept {
+        img.textureBytes = textureSize(img.texture.get());
+        img.layerBytes = img.layer.pixels.size() * sizeof(uint32_t);
+        textureBytes += img.textureBytes;
+        layerBytes += img.layerBytes;
+    }
+
+    void Image::untrack(ImageData &img) noexcept {
+        textureBytes -= img.textureBytes;
+        layerBytes -= img.layerBytes;
+        img.textureBytes = 0;
+        img.layerBytes = 0;
+        // the layer goes with the texture (evicted, released or replaced)
+        img.layer = {};
+    }
+
+    void Image::touch(ImageData &img) noexcept {
+        img.lastUse = ++useCount;
+        img.lastScene = sceneCount;
+    }
+
+    void Image::trim() {
+        // a layer is a second copy of its texture, both count
+        if (textureBytes + layerBytes <= textureBudget)
+            return;
+
+        // only reloadable textures that the current scene has not used
+        std::vector<std::pair<uint64_t, ImageHandle>> candidates;
+        registry.forEach([&](ImageHandle handle, ImageData &img) {
+            if (img.texture != nullptr && img.lastScene != sceneCount && reloadList.contains(img.name))
+                candidates.emplace_back(img.lastUse, handle);
+        });
+
+        // least recently used first
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const auto &a, const auto &b) { return a.first < b.first; });
+
+        for (const auto &[lastUse, handle] : candidates) {
+            if (textureBytes + layerBytes <= textureBudget)
+                break;
+
+            ImageData *img = registry.get(handle);
+            untrack(*img);
+            img->texture = nullptr;
+        }
+    }
+
+    void Image::markSceneChange() {
+        ++sceneCount;
+        trim();
+    }
+
+    void Image::setTextureBudget(size_t bytes) {
+        textureBudget = bytes;
+        trim();
+    }
+
+    size_t Image::getTextureBytes() const noexcept {
+        return textureBytes;
+    }
+
+    size_t Image::getLayerBytes() const noexcept {
+        return layerBytes;
+    }
+
+    ImageHandle Image::createRenderTarget(SDL_Renderer *ren, unsigned int width, unsigned int height) {
+        SDL_Texture *texture =
+            SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (texture == nullptr) {
+            panicln("Render Target failed to be created");
+            return {};
         }
 
-        TTF_Font *outlineFont = TTF_OpenFont(msg.fontFile.data(), msg.fontSize);
+        const ImageHandle handle = registry.create();
+        ImageData *newImage = registry.get(handle);
+        if (newImage == nullptr) {
+            SDL_DestroyTexture(texture);
+            return {};
+        }
+        setTexture(*newImage, texture);
+
+        return handle;
+    }
+
+    ImageHandle Image::setText(ImageHandle target, SDL_Texture *texture, uint64_t key, Layer &&layer) {
+        ImageData *img = registry.get(target);
+        if (img == nullptr) {
+            target = registry.create();
+            img = registry.get(target);
+            if (img == nullptr) {
+                SDL_DestroyTexture(texture);
+                return {};
+            }
+        }
+
+        setTexture(*img, texture, std::move(layer));
+        img->textKey = key;
+        img->owner = MemTag::Text;
+        touch(*img);
+
+        return target;
+    }
+
+    ImageHandle Image::findText(ImageHandle target, uint64_t key) noexcept {
+        ImageData *img = registry.get(target);
+        if (img == nullptr || img->texture == nullptr || img->textKey != key)
+            return {};
+
+        touch(*img);
+
+        return target;
+    }
+
+    TTF_Font *Image::getFont(std::string_view fontFile, int fontSize, int outline) {
+        MemoryScope scope(MemTag::Text);
+        uint64_t key = fnv1a(fontFile.data(), fontFile.size());
+        key = fnv1a(&fontSize, sizeof(fontSize), key);
+        key = fnv1a(&outline, sizeof(outline), key);
+
+        auto iter = fonts.find(key);
+        if (iter != fonts.end())
+            return iter->second.get();
+
+        TTF_Font *font = TTF_OpenFont(std::basic_string<char>(fontFile).c_str(), fontSize);
         if (font == nullptr) {
             panicln("TTF_OpenFont error");
             return nullptr;
         }
 
-        TTF_SetFontOutline(outlineFont, msg.outlineThickness);
+        if (outline != 0)
+            TTF_SetFontOutline(font, outline);
+
+        fonts.insert({key, cheesecake(font)});
+
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(fontFile, error);
+        if (!error)
+            fontFileBytes += fileSize;
+
+        return font;
+    }
+
+    void Image::clearFonts() noexcept {
+        fonts.clear();
+        fontFileBytes = 0;
+    }
+
+    size_t Image::getFontCount() const noexcept {
+        return fonts.size();
+    }
+
+    uint64_t Image::getFontFileBytes() const noexcept {
+        return fontFileBytes;
+    }
+
+    ImageHandle Image::createText(const MessageData &msg, SDL_Renderer *ren, ImageHandle target) {
+        MemoryScope scope(MemTag::Text);
+        uint64_t key = fnv1a(msg.msg.data(), msg.msg.size());
+        key = fnv1a(msg.fontFile.data(), msg.fontFile.size(), key);
+        key = fnv1a(&msg.col.textColor, sizeof(SDL_Color), key);
+        key = fnv1a(&msg.fontSize, sizeof(msg.fontSize), key);
+
+        // the same message is not rendered again
+        if (findText(target, key))
+            return target;
+
+        TraceScope trace("createText");
+        TTF_Font *font = getFont(msg.fontFile, msg.fontSize);
+        if (font == nullptr)
+            return target;
+
+        SDL_Surface *surf = TTF_RenderText_Blended(font, msg.msg.data(), msg.col.textColor);
+        if (surf == nullptr) {
+            panicln("TTF_RenderText error");
+            return target;
+        }
+
+        Layer layer {};
+        SDL_Texture *texture = createTexture(surf, ren, &layer);
+
+        if (texture == nullptr) {
+            panicln("Failed to create text image");
+            return target;
+        }
+
+        return setText(target, texture, key, std::move(layer));
+    }
+
+    ImageHandle Image::createTextA(const MessageData &msg, SDL_Renderer *ren, ImageHandle target) {
+        MemoryScope scope(MemTag::Text);
+        uint64_t key = fnv1a(msg.msg.data(), msg.msg.size());
+        key = fnv1a(msg.fontFile.data(), msg.fontFile.size(), key);
+        key = fnv1a(&msg.col.textColor, sizeof(SDL_Color), key);
+        key = fnv1a(&msg.fontSize, sizeof(msg.fontSize), key);
+        key = fnv1a(&msg.outlineThickness, sizeof(msg.outlineThickness), key);
+
+        // the same message is not rendered again
+        if (findText(target, key))
+            return target;
+
+        TraceScope trace("createTextA");
+        TTF_Font *font = getFont(msg.fontFile, msg.fontSize);
+        TTF_Font *outlineFont = getFont(msg.fontFile, msg.fontSize, msg.outlineThickness);
+        if (font == nullptr || outlineFont == nullptr)
+            return target;
 
         SDL_Surface *bgSurf = TTF_RenderText_Blended(font, msg.msg.data(), msg.col.textColor);
         SDL_Surface *fgSurf = TTF_RenderText_Blended(outlineFont, msg.msg.data(), {0x00, 0x00, 0x00});
+        if (bgSurf == nullptr || fgSurf == nullptr) {
+            SDL_FreeSurface(bgSurf);
+            SDL_FreeSurface(fgSurf);
+            panicln("TTF_RenderText error");
+            return target;
+        }
 
         // destination rect that gets the size of the surface (explicit x/y for those that want to understand without
         // digging) 1 is the offset from the outline
         SDL_Rect position = {position.x = 1, position.y = 1, fgSurf->w, fgSurf->h};
         SDL_BlitSurface(bgSurf, nullptr, fgSurf, &position);
 
-        newImage->texture = cheesecake(SDL_CreateTextureFromSurface(ren, fgSurf));
-        if (newImage->texture == nullptr) {
+        trackSurface(bgSurf, true);
+        Layer layer {};
+        SDL_Texture *texture = createTexture(fgSurf, ren, &layer);
+        trackSurface(bgSurf, false);
+        SDL_FreeSurface(bgSurf);
+
+        if (texture == nullptr) {
             panicln("Failed to create outline text image");
-            return nullptr;
-        }
-        // get the size of the surface
-        if (TTF_SizeUTF8(font, msg.msg.data(), &newImage->imageWidth, &newImage->imageHeight) != 0) {
-            panicln("Failed to retrieve text size");
-            return nullptr;
+            return target;
         }
 
-        images.insert({msg.fontFile, newImage});
+        return setText(target, texture, key, std::move(layer));
+    }
 
-        SDL_FreeSurface(bgSurf);
-        SDL_FreeSurface(fgSurf);
-        TTF_CloseFont(outlineFont);
-        TTF_CloseFont(font);
+    void Image::draw(ImageHandle img, SDL_Renderer *ren, int x, int y, double sx, double sy,
+                     SDL_Rect *clip) noexcept {
+        ImageData *data = registry.get(img);
+        if (data == nullptr || (data->texture == nullptr && reload(*data, ren) != 0))
+            return;
 
-        return newImage;
-    }
+        touch(*data);
 
-    void Image::draw(IMD &img, SDL_Renderer *ren, int x, int y, double sx, double sy, SDL_Rect *clip) noexcept {
-        SDL_Rect dst {img->imagePos1 = x, img->imagePos2 = y, 0, 0};
+        SDL_Rect dst {data->imagePos1 = x, data->imagePos2 = y, data->imageWidth, data->imageHeight};
         if (clip != nullptr) {
             dst.w = clip->w;
             dst.h = clip->h;
-        } else {
-            SDL_QueryTexture(img->texture.get(), nullptr, nullptr, &dst.w, &dst.h);
         }
 
         if ((sx && sy) != 0) {
@@ -142,45 +592,118 @@ namespace Application::Helper {
             dst.h *= static_cast<int>(sy);
         }
 
-        SDL_RenderCopy(ren, img->texture.get(), clip, &dst);
+        if (drawTarget != nullptr) {
+            if (const Layer *layer = findLayer(*data, ren); layer != nullptr)
+                drawTarget->blendScaled(*layer, clip, dst, layer->premultiplied ? premultiplyMod(data->color)
+                                                                                 : data->color);
+            return;
+        }
+
+        SDL_RenderCopy(ren, data->texture.get(), clip, &dst);
+    }
+
+    void Image::drawAnimation(ImageHandle img, SDL_Renderer *ren, int x, int y, double scale) noexcept {
+        SDL_Texture *texture = getTexture(img, ren);
+        if (texture == nullptr)
+            return;
+
+        ImageData *data = registry.get(img);
+        if (drawTarget != nullptr) {
+            SDL_Rect clip {0};
+            SDL_Rect dst {0};
+            const Layer *layer = findLayer(*data, ren);
+            if (layer != nullptr && animation.getRects(x, y, scale, clip, dst))
+                drawTarget->blendScaled(*layer, &clip, dst, layer->premultiplied ? premultiplyMod(data->color)
+                                                                                  : data->color);
+            return;
+        }
+
+        animation.draw(texture, ren, x, y, scale);
     }
 
-    void Image::drawAnimation(IMD &img, SDL_Renderer *ren, int x, int y, double scale) const noexcept {
-        animPtr->draw(img, ren, x, y, scale);
+    void Image::setKeepLayers(bool keep) noexcept {
+        keepLayers = keep;
     }
 
-    int Image::add(std::string_view str, IMD &img) {
-        auto iter = images.find(str.data());
-        if (iter != images.end()) {
+    void Image::setDrawTarget(Compositor *target) noexcept {
+        drawTarget = target;
+    }
+
+    Compositor *Image::getDrawTarget() const noexcept {
+        return drawTarget;
+    }
+
+    const Layer *Image::getLayer(ImageHandle img, SDL_Renderer *ren) noexcept {
+        ImageData *data = registry.get(img);
+
+        return (data == nullptr) ? nullptr : findLayer(*data, ren);
+    }
+
+    SDL_Texture *Image::getTexture(ImageHandle img, SDL_Renderer *ren) noexcept {
+        ImageData *data = registry.get(img);
+        if (data == nullptr || (data->texture == nullptr && reload(*data, ren) != 0))
+            return nullptr;
+
+        touch(*data);
+
+        return data->texture.get();
+    }
+
+    SDL_Point Image::getSize(ImageHandle img) noexcept {
+        const ImageData *data = registry.get(img);
+        if (data == nullptr)
+            return {0, 0};
+
+        return {data->imageWidth, data->imageHeight};
+    }
+
+    Registry &Image::getRegistry() noexcept {
+        return registry;
+    }
+
+    int Image::add(std::string_view str, ImageHandle img) {
+        if (registry.find(str)) {
             println("Image already exists");
             return -1;
-        } else {
-            images.insert({str.data(), img});
-            if (images.find(str.data()) != images.end())
-                println("Created image");
         }
 
+        if (registry.assign(str, img) != 0) {
+            println("Failed to add image");
+            return -1;
+        }
+        println("Created image");
+
         return 0;
     }
 
-    int Image::remove(IMD &img) {
-        if (images.contains(img->path)) {
-            images.erase(img->path);
-            img = nullptr;
-        } else {
+    int Image::remove(ImageHandle &img) {
+        ImageData *data = registry.get(img);
+        if (data == nullptr) {
             println("Failed to remove image");
             return -1;
         }
 
+        untrack(*data);
+        if (registry.find(registry.getName(data->name)) == img)
+            reloadList.erase(data->name);
+        registry.release(img);
+        img = {};
+
         return 0;
     }
 
-    void Image::setTextureColor(IMD &img, SDL_Color col) const noexcept {
-        SDL_SetTextureColorMod(img->texture.get(), col.r, col.g, col.b);
-        SDL_SetTextureAlphaMod(img->texture.get(), col.a);
+    void Image::setTextureColor(ImageHandle img, SDL_Color col) noexcept {
+        ImageData *data = registry.get(img);
+        if (data == nullptr)
+            return;
+
+        // kept so a reloaded texture gets the same colour
+        data->color = col;
+        applyColor(*data);
     }
 
-    IMD Image::createPack(std::string_view packName, std::string_view dirPath, SDL_Renderer *ren) {
+    ImageHandle Image::createPack(std::string_view packName, std::string_view dirPath, SDL_Renderer *ren) {
+        TraceScope scope("createPack");
         std::vector<std::basic_string<char>> pathList;
         // get the directory path and append all of the files into the array
         for (const auto &pathIter : std::filesystem::directory_iterator(dirPath)) {
@@ -197,68 +720,119 @@ namespace Application::Helper {
         int imageWidth = 0;
         int imageHeight = 0;
 
-        // store a map containing the texture (loaded with the path)
-        IMD newImage = {nullptr};
+        // the frames (in pathList order) are only needed while the atlas is built and are removed afterwards
+        std::vector<ImageHandle> imagePackList;
+        imagePackList.reserve(pathList.size());
         for (const auto &path : pathList) {
-            newImage = createImage(path, ren);
-            SDL_QueryTexture(newImage->texture.get(), nullptr, nullptr, &newImage->imageWidth, &newImage->imageHeight);
-            imageWidth = newImage->imageWidth;
-            imageHeight = newImage->imageHeight;
-            imagePackList.insert({path, newImage});
+            const ImageHandle newImage = createImage(path, ren);
+            const SDL_Point size = getSize(newImage);
+            imageWidth = size.x;
+            imageHeight = size.y;
+            imagePackList.emplace_back(newImage);
         }
 
         // our 1D array is now prepped, now we need to align it on our atlas texture
-        IMD canvas = {nullptr};
+        ImageHandle canvas = {};
         // expand the width to create a large-width based canvas
         canvas = createRenderTarget(ren, imageWidth * static_cast<unsigned int>(pathList.size()), imageHeight);
+        if (!canvas) {
+            for (ImageHandle &frame : imagePackList) {
+                if (frame)
+                    remove(frame);
+            }
+            return {};
+        }
 
-        SDL_SetRenderTarget(ren, canvas->texture.get());
+        // the frames go onto the canvas through the renderer, even while a compositor is the draw target; the pack can
+        // be built while drawing (a scene loaded under a menu), into a transition snapshot or the backdrop target
+        Compositor *previousTarget = drawTarget;
+        SDL_Texture *previousRenderTarget = SDL_GetRenderTarget(ren);
+        drawTarget = nullptr;
+        SDL_SetRenderTarget(ren, getTexture(canvas, ren));
         int iterWidth = 0; // the image iteration width (0, 148, 296, etc..)
         bool firstElement = true; // to place the first image at origin
         // unload our list onto the canvas
-        for (const auto &i : pathList) {
+        for (const auto &i : imagePackList) {
             // place them sequentially on the canvas
             if (firstElement) {
-                draw(imagePackList[i], ren, 0, 0);
+                draw(i, ren, 0, 0);
             } else {
-                draw(imagePackList[i], ren, iterWidth += imageWidth, 0);
+                draw(i, ren, iterWidth += imageWidth, 0);
             }
             firstElement = false;
         }
-        SDL_SetRenderTarget(ren, nullptr);
-        // fill width and height for querying
-        SDL_QueryTexture(canvas->texture.get(), nullptr, nullptr, &canvas->imageWidth, &canvas->imageHeight);
+        SDL_SetRenderTarget(ren, previousRenderTarget);
+        drawTarget = previousTarget;
+
+        // the same atlas on the cpu, from the layers of the frames
+        Layer canvasLayer {};
+        if (keepLayers) {
+            canvasLayer.w = imageWidth * static_cast<int>(imagePackList.size());
+            canvasLayer.h = imageHeight;
+            canvasLayer.pixels.assign(static_cast<size_t>(canvasLayer.w) * canvasLayer.h, 0);
+            canvasLayer.opaque = true;
+            canvasLayer.premultiplied = premultiplyLayers;
+            for (size_t i = 0; i < imagePackList.size(); ++i) {
+                const Layer *frame = getLayer(imagePackList[i], ren);
+                // a frame that failed to load (or was read back with other alpha), the canvas is read back from its
+                // texture when it is first drawn
+                if (frame == nullptr || frame->premultiplied != canvasLayer.premultiplied) {
+                    canvasLayer = {};
+                    break;
+                }
+
+                const int w = std::min(frame->w, imageWidth);
+                for (int y = 0; y < std::min(frame->h, imageHeight); ++y) {
+                    std::copy_n(frame->pixels.data() + static_cast<size_t>(y) * frame->w, w,
+                                canvasLayer.pixels.data() + static_cast<size_t>(y) * canvasLayer.w +
+                                    static_cast<size_t>(i) * imageWidth);
+                }
+                canvasLayer.opaque = canvasLayer.opaque && frame->opaque && w == imageWidth &&
+                                     frame->h >= imageHeight;
+            }
+        }
+
+        // the canvas holds every frame now, releasing it has to give all of their memory back
+        for (ImageHandle &frame : imagePackList) {
+            if (frame)
+                remove(frame);
+        }
+
         // add canvas to Image container
         add(packName, canvas);
+        if (ImageData *data = registry.get(canvas); data != nullptr) {
+            data->owner = MemTag::Animation;
+            data->layer = std::move(canvasLayer);
+        }
 
         return canvas;
     }
 
     int Image::getPackWidth(std::string_view packName) noexcept {
-        auto findPack = images.find(packName.data());
-        if (findPack == images.end()) {
+        const ImageData *findPack = registry.get(registry.find(packName));
+        if (findPack == nullptr) {
             println("Failed to get pack");
             return -1;
         }
 
-        return images[packName.data()]->imageWidth;
+        return findPack->imageWidth;
     }
 
     int Image::getPackHeight(std::string_view packName) noexcept {
-        auto findPack = images.find(packName.data());
-        if (findPack == images.end()) {
+        const ImageData *findPack = registry.get(registry.find(packName));
+        if (findPack == nullptr) {
             println("Failed to get pack");
             return -1;
         }
 
-        return images[packName.data()]->imageHeight;
+        return findPack->imageHeight;
     }
 
-    std::shared_ptr<Animation> Image::getAnimPtr() noexcept {
-        return animPtr;
+    Animation *Image::getAnimPtr() noexcept {
+        return &animation;
     }
 
     constexpr void Image::printImageCount() const noexcept {
-        println("Image Size", images.size());
+        println("Image Size", registry.size());
     }
-} // namespace Application::Helper
\ No newline at end of file
+} // namespace Application::Helper
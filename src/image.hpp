@@ -5,36 +5,83 @@
 #include <SDL_ttf.h>
 #include "animation.hpp"
 #include "data.hpp"
+#include "diskcache.hpp"
+#include "registry.hpp"
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 
 /** Structure
  *
  * ImageData -> has the texture we want to actually operate on (SDL_Texture)
- * IMD -> ImageData Smart Pointer
+ * ImageHandle -> 32-bit generational handle to an ImageData slot in the Registry
+ * Variant -> an image is named by its file, fit & key, so one file loaded with different parameters is two images
  * Image -> operates on ImageData (which contains an SDL_Texture and its related info)
- * Pack -> creates a texture atlas full of image objects and constructs them into a 1D array
+ * Pack -> creates a texture atlas full of image objects and constructs them into a 1D array (the frames are removed
+ *         once they are on the atlas)
+ * DiskCache -> decoded pixels of fitted images (backgrounds) that survive between launches
+ * Budget -> texture & layer bytes of the images in the registry, least recently used images are evicted & reloaded
+ *           on use
+ * Declared -> an image registered without loading it (scene manifests), loaded by loadImages or on first use
+ * Text -> fonts are opened once per file, size & outline; a text image is only rendered again if its message changed
+ * Premultiplied -> (opt-in) surfaces are premultiplied once before upload & drawn with a matching custom blend mode,
+ *                  renderers without custom blend modes (SDL's software renderer) keep straight alpha textures; the
+ *                  layers are premultiplied either way & blended that way by the Compositor
+ * Layers -> (opt-in) a copy of every uploaded surface is kept on the CPU; while a Compositor is the
+ *           draw target, images with a layer are drawn into its frame instead of through SDL_RenderCopy
  */
 
 namespace Application::Helper {
+    class Compositor;
+
     class Image {
     public:
-        /** Create an image to be used for rendering. You can add a colour to be set transparent.
+        /** Create an image to be used for rendering. You can add a colour to be set transparent, it is turned into
+         *  alpha once at load so the image is drawn like any other alpha image (no colour key test per blit).
+         *  Images with a fit size are downscaled to cover it and kept in the on-disk cache, so the next load
+         *  of the same unchanged file skips decoding. The same file with another fit or key is a separate image.
          *
          * \param filePath -> the location of the image file
          * \param ren -> the renderer to use
          * \param key -> the colour to be removed from the image (primarily background colours)
-         * \return the created image or nullptr if the operation failed.
+         * \param fit -> (optional) the size the image should cover, such as the window (primarily backgrounds)
+         * \param keyTolerance -> (optional) the channel difference to the key that is still faded out (soft edges)
+         * \return the created image or an empty handle if the operation failed.
+         */
+        ImageHandle createImage(std::string_view filePath, SDL_Renderer *ren, SDL_Color *key = nullptr,
+                        const SDL_Point *fit = nullptr, uint8_t keyTolerance = 0);
+        /** Registers an image without loading it, it is loaded by loadImages or the first time it is drawn.
+         *
+         * \param filePath -> the location of the image file
+         * \param key -> (optional) the colour to be removed from the image
+         * \param fit -> (optional) the size the image should cover
+         * \param keyTolerance -> (optional) the channel difference to the key that is still faded out
+         * \return the image (an existing one if the file was created or declared before with the same fit & key) or an
+         *         empty handle.
          */
-        IMD createImage(std::string_view filePath, SDL_Renderer *ren, SDL_Color *key = nullptr);
+        ImageHandle declareImage(std::string_view filePath, const SDL_Color *key = nullptr,
+                                 const SDL_Point *fit = nullptr, uint8_t keyTolerance = 0);
+        /** Makes images resident, the ones already loaded are only marked as used.
+         *
+         * \param images -> the images to load
+         * \param ren -> the renderer to use
+         * \return 0 if the operation succeeded, otherwise -1 if any image failed to load.
+         */
+        int loadImages(std::span<const ImageHandle> images, SDL_Renderer *ren);
+        /** Frees the textures of images that can be loaded again (files), they stay in the registry.
+         *
+         * \param images -> the images to release
+         */
+        void releaseImages(std::span<const ImageHandle> images) noexcept;
         /** Create a render target to draw on top of.
          *
          * \param ren -> the renderer to use
          * \param width -> the width of the image
          * \param height -> the height of the image
-         * \return the image to be used as a render target or nullptr if the operation failed.
+         * \return the image to be used as a render target or an empty handle if the operation failed.
          */
-        IMD createRenderTarget(SDL_Renderer *ren, unsigned int w, unsigned int h);
+        ImageHandle createRenderTarget(SDL_Renderer *ren, unsigned int w, unsigned int h);
         /** Create a text image.
          *
          * \param msg -> a struct constructed with:
@@ -44,9 +91,10 @@ namespace Application::Helper {
          * \param - fontSize -> the size of the text
          * \param - outlineThickness -> the thickness of the text outline
          * \param ren -> the renderer to use
-         * \return the text image or nullptr if the operation failed.
+         * \param target -> (optional) the previous text image, its slot is reused instead of allocating a new one
+         * \return the text image (target if it was given) or an empty handle if the operation failed.
          */
-        IMD createText(const MessageData &msg, SDL_Renderer *ren);
+        ImageHandle createText(const MessageData &msg, SDL_Renderer *ren, ImageHandle target = {});
         /** Create text with an outline as an image.
          *
          * \param msg -> a struct constructed with:
@@ -56,9 +104,31 @@ namespace Application::Helper {
          * \param - fontSize -> the size of the text
          * \param - outlineThickness -> the thickness of the text outline
          * \param ren -> the renderer to use
-         * \return the text image with an outline or nullptr if the operation failed.
+         * \param target -> (optional) the previous text image, its slot is reused instead of allocating a new one
+         * \return the text image with an outline (target if it was given) or an empty handle if the operation failed.
+         */
+        ImageHandle createTextA(const MessageData &msg, SDL_Renderer *ren, ImageHandle target = {});
+        /** Gets a font from the font cache, it is opened the first time it is asked for.
+         *
+         * \param fontFile -> the font file
+         * \param fontSize -> the point size of the font
+         * \param outline -> (optional) the outline thickness of the font
+         * \return the font (owned by the cache) or nullptr if the font failed to open.
          */
-        IMD createTextA(const MessageData &msg, SDL_Renderer *ren);
+        TTF_Font *getFont(std::string_view fontFile, int fontSize, int outline = 0);
+        /* Closes every cached font, call it before TTF_Quit.
+         */
+        void clearFonts() noexcept;
+        /** Gets the number of open fonts.
+         *
+         * \return the fonts in the cache.
+         */
+        size_t getFontCount() const noexcept;
+        /** Gets the size of the files of the open fonts, what FreeType allocates for them is not included.
+         *
+         * \return the bytes of the font files, counted once per open font.
+         */
+        uint64_t getFontFileBytes() const noexcept;
         /** Create an Image Pack (texture atlas).
          *
          *  extracted gif images are placed sequentially on the texture atlas
@@ -74,14 +144,14 @@ namespace Application::Helper {
          * \param packName -> the name of the image pack canvas that will be added to the map.
          * \param dirPath -> the directory of the files, not the actual files!
          * \param ren -> the renderer to use
-         * \return the image (canvas) or nullptr if the operation failed.
+         * \return the image (canvas) or an empty handle if the operation failed.
          */
-        IMD createPack(std::string_view packName, std::string_view dirPath, SDL_Renderer *ren);
+        ImageHandle createPack(std::string_view packName, std::string_view dirPath, SDL_Renderer *ren);
         /** Gets the animation pointer for adding & drawing animations.
          *
          * \return the pointer associated with the image animation.
          */
-        std::shared_ptr<Animation> getAnimPtr() noexcept;
+        Animation *getAnimPtr() noexcept;
         /** Gets the Image Pack width.
          *
          * \param packName -> the name of the image that was packed
@@ -94,19 +164,19 @@ namespace Application::Helper {
          * \return the height of the image pack or -1 if the image pack was not found.
          */
         int getPackHeight(std::string_view packName) noexcept;
-        /** Emplace an image with a nametag into the map.
+        /** Give an image a nametag in the registry.
          *
          * \param str -> the nametag of the image
-         * \param img -> the image to be inserted into the map
+         * \param img -> the image to be found by the nametag
          * \return 0 if the operation succeeded, otherwise -1 if it failed.
          */
-        int add(std::string_view str, IMD &img);
-        /** Remove an image out of the map.
+        int add(std::string_view str, ImageHandle img);
+        /** Remove an image out of the registry.
          *
-         * \param img -> the image to be removed from the map & safely freed.
+         * \param img -> the image to be removed from the registry & safely freed (reset to an empty handle).
          * \return 0 if the operation succeeded, otherwise -1 if it failed.
          */
-        int remove(IMD &img);
+        int remove(ImageHandle &img);
         /** Renders an image to the screen.
          *
          * \param img -> the image to draw
@@ -116,7 +186,7 @@ namespace Application::Helper {
          * \param scale -> scale up or down the image width and height (0 if default)
          * \param clip -> the portion of the image to render (nullptr if default)
          */
-        void draw(IMD &img, SDL_Renderer *ren, int x, int y, double sx = 0.0, double sy = 0.0,
+        void draw(ImageHandle img, SDL_Renderer *ren, int x, int y, double sx = 0.0, double sy = 0.0,
                   SDL_Rect *clip = nullptr) noexcept;
         /** Renders an animation (or GIF from Image Pack) to the screen.
          *
@@ -126,20 +196,136 @@ namespace Application::Helper {
          * \param y -> y position of the image
          * \param scale -> scale up or down the image width and height (0 if default)
          */
-        void drawAnimation(IMD &img, SDL_Renderer *ren, int x, int y, double scale = 0) const noexcept;
+        void drawAnimation(ImageHandle img, SDL_Renderer *ren, int x, int y, double scale = 0) noexcept;
+        /** Keeps a CPU copy (layer) of the surfaces uploaded from now on, for drawing them with a Compositor.
+         *
+         * \param keep -> true to keep layers, false to only keep textures
+         */
+        void setKeepLayers(bool keep) noexcept;
+        /** Sets where draw & drawAnimation go, an image without a layer is read back from its texture once.
+         *
+         * \param target -> the compositor to draw into, nullptr to draw through the renderer
+         */
+        void setDrawTarget(Compositor *target) noexcept;
+        /** Gets the compositor images are drawn into.
+         *
+         * \return the draw target or nullptr if images are drawn through the renderer.
+         */
+        Compositor *getDrawTarget() const noexcept;
+        /** Gets the CPU copy of an image (call getTexture first, an evicted image has none). While a compositor is the
+         *  draw target, an image without one has it read back from its texture.
+         *
+         * \param img -> the image to use
+         * \param ren -> the renderer of the texture (for the read back)
+         * \return the layer or nullptr if the image has none.
+         */
+        const Layer *getLayer(ImageHandle img, SDL_Renderer *ren) noexcept;
         /** Modifies the colour of the image.
          *
          * \param img -> the image to modify
          * \param col -> the colour to set the image to
          */
-        void setTextureColor(IMD &img, SDL_Color col) const noexcept;
+        void setTextureColor(ImageHandle img, SDL_Color col) noexcept;
+        /** Gets the texture of an image to render it directly, loading it again if it was evicted.
+         *
+         * \param img -> the image to use
+         * \param ren -> the renderer to use
+         * \return the texture or nullptr if the handle is stale or the texture failed to load.
+         */
+        SDL_Texture *getTexture(ImageHandle img, SDL_Renderer *ren) noexcept;
+        /** Gets the cached size of an image (no texture query).
+         *
+         * \param img -> the image to use
+         * \return the width (x) and height (y) of the image, 0 if the handle is stale.
+         */
+        SDL_Point getSize(ImageHandle img) noexcept;
+        /** Gets the registry the images live in.
+         *
+         * \return the image registry.
+         */
+        Registry &getRegistry() noexcept;
         /* Prints the number of images in the map.
          */
         constexpr void printImageCount() const noexcept;
+        /* Marks the start of a new scene. Textures the new scene has not used yet become candidates for eviction.
+         */
+        void markSceneChange();
+        /** Sets the texture memory budget (textures & their layers). Least recently used images are evicted once it
+         *  is exceeded, they are loaded again the next time they are used.
+         *
+         * \param bytes -> the maximum number of texture & layer bytes to keep resident
+         */
+        void setTextureBudget(size_t bytes);
+        /** Turns the premultiplied-alpha pipeline on or off for images created from now on. The layers are
+         *  premultiplied even if the renderer cannot draw premultiplied textures.
+         *
+         * \param ren -> the renderer to use (checked for custom blend mode support)
+         * \param enable -> true to premultiply, false for straight alpha
+         * \return 0 if the operation succeeded, otherwise -1 if the renderer cannot draw premultiplied textures (only
+         *         the layers are premultiplied).
+         */
+        int setPremultipliedAlpha(SDL_Renderer *ren, bool enable);
+        /** Gets the texture memory held by the images in the registry.
+         *
+         * \return the number of texture bytes (width * height * bytes per pixel).
+         */
+        size_t getTextureBytes() const noexcept;
+        /** Gets the CPU memory held by the layers of the images in the registry.
+         *
+         * \return the number of layer bytes (width * height * 4).
+         */
+        size_t getLayerBytes() const noexcept;
+
+    private:
+        // what is needed to load an evicted image again
+        struct ReloadData final {
+            // the file, the registry name also has the fit & key in it
+            std::basic_string<char> filePath {};
+            std::optional<SDL_Color> key {};
+            uint8_t keyTolerance {0};
+            std::optional<SDL_Point> fit {};
+        };
+
+        SDL_Texture *loadTexture(std::string_view filePath, SDL_Renderer *ren, const SDL_Color *key,
+                                 const SDL_Point *fit, uint8_t keyTolerance, Layer *layer);
+        int reload(ImageData &img, SDL_Renderer *ren);
+        ImageHandle setText(ImageHandle target, SDL_Texture *texture, uint64_t key, Layer &&layer);
+        ImageHandle findText(ImageHandle target, uint64_t key) noexcept;
+        // the layer is filled when layers are kept
+        SDL_Texture *createTexture(SDL_Surface *surf, SDL_Renderer *ren, Layer *layer);
+        void setTexture(ImageData &img, SDL_Texture *texture, Layer &&layer = {}) noexcept;
+        // the layer of an image, read back from its texture if there is none & a compositor is the draw target
+        const Layer *findLayer(ImageData &img, SDL_Renderer *ren) noexcept;
+        void applyColor(const ImageData &img) noexcept;
+        void track(ImageData &img) noexcept;
+        void untrack(ImageData &img) noexcept;
+        void touch(ImageData &img) noexcept;
+        void trim();
+        static ReloadData makeReloadData(std::string_view filePath, const SDL_Color *key, const SDL_Point *fit,
+                                         uint8_t keyTolerance);
 
     private:
-        std::unordered_map<std::basic_string<char>, IMD> images {};
-        std::unordered_map<std::basic_string<char>, IMD> imagePackList {};
-        std::shared_ptr<Animation> animPtr {std::make_shared<Animation>()};
+        Registry registry {};
+        // keyed by the interned name (the file path, plus the fit & key if any)
+        std::unordered_map<uint32_t, ReloadData> reloadList {};
+        Animation animation {};
+        DiskCache diskCache {};
+        // keyed by the hash of the file, size & outline
+        std::unordered_map<uint64_t, Utils::SMD<TTF_Font>> fonts {};
+        uint64_t fontFileBytes {0};
+        // the gif atlas alone takes 3.6mb, twice that with its layer
+        size_t textureBudget {8 * 1024 * 1024};
+        size_t textureBytes {0};
+        size_t layerBytes {0};
+        uint64_t useCount {0};
+        uint64_t sceneCount {0};
+        bool premultiply {false};
+        bool premultiplyLayers {false};
+        bool keepLayers {false};
+        Compositor *drawTarget {nullptr};
+        // one (source) + one minus source alpha for colour & alpha
+        SDL_BlendMode premultipliedBlend {SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE,
+            SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD)};
     };
 } // namespace Application::Helper
\ No newline at end of file
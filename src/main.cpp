@@ -1,10 +1,36 @@
 #include "anya.hpp"
+#include <cstdlib>
 
 using namespace Application;
 
-int main(int, char **)
+int main(int argc, char **argv)
 {
-	auto inst = Anya();
+	// anya [--record <file>] [--replay <file> [--report <file>]] [--trace <file>] [--power <profile>] [--alpha <mode>]
+	//      [--release-after <seconds>] [--clock <zone>]... [--draw <cpu|sdl>]
+	LaunchOptions options;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const std::string_view arg = argv[i];
+		if (arg == "--record")
+			options.recordFile = argv[i + 1];
+		else if (arg == "--replay")
+			options.replayFile = argv[i + 1];
+		else if (arg == "--report")
+			options.reportFile = argv[i + 1];
+		else if (arg == "--trace")
+			options.traceFile = argv[i + 1];
+		else if (arg == "--power")
+			options.powerProfile = argv[i + 1];
+		else if (arg == "--alpha")
+			options.alphaMode = argv[i + 1];
+		else if (arg == "--release-after")
+			options.releaseAfter = std::atoi(argv[i + 1]);
+		else if (arg == "--clock")
+			options.clockZones.emplace_back(argv[i + 1]);
+		else if (arg == "--draw")
+			options.drawMode = argv[i + 1];
+	}
+
+	auto inst = Anya(options);
 
 	return 0;
-}
\ No newline at end of file
+}
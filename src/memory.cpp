@@ -0,0 +1,220 @@
+#include "memory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <map>
+#include <new>
+
+namespace Application::Helper {
+    namespace {
+        struct Counter final {
+            std::atomic<uint64_t> bytes {0};
+            std::atomic<uint64_t> peak {0};
+            std::atomic<uint64_t> allocations {0};
+        };
+
+        // in front of every block, 16 bytes so the block keeps the alignment of malloc
+        struct alignas(std::max_align_t) Header final {
+            uint64_t size;
+            MemTag tag;
+        };
+
+        Counter heap[static_cast<size_t>(MemTag::Count)] {};
+        Counter surfaces {};
+        std::atomic<uint64_t> surfaceTotal {0};
+        thread_local MemTag currentTag {MemTag::Other};
+
+        constexpr const char *tagNames[] = {"other", "image", "animation", "interface", "text"};
+        static_assert(std::size(tagNames) == static_cast<size_t>(MemTag::Count));
+
+        void raisePeak(std::atomic<uint64_t> &peak, uint64_t value) noexcept {
+            uint64_t seen = peak.load(std::memory_order_relaxed);
+            while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+            }
+        }
+
+        void add(Counter &counter, uint64_t bytes) noexcept {
+            const uint64_t now = counter.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            counter.allocations.fetch_add(1, std::memory_order_relaxed);
+            raisePeak(counter.peak, now);
+        }
+
+        void sub(Counter &counter, uint64_t bytes) noexcept {
+            counter.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+            counter.allocations.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+#ifndef ANYA_NO_HEAP_HOOKS
+        void *allocate(size_t size) noexcept {
+            auto *header = static_cast<Header *>(std::malloc(sizeof(Header) + size));
+            if (header == nullptr)
+                return nullptr;
+
+            header->size = size;
+            header->tag = currentTag;
+            add(heap[static_cast<size_t>(header->tag)], size);
+
+            return header + 1;
+        }
+
+        void deallocate(void *ptr) noexcept {
+            if (ptr == nullptr)
+                return;
+
+            Header *header = static_cast<Header *>(ptr) - 1;
+            sub(heap[static_cast<size_t>(header->tag)], header->size);
+            std::free(header);
+        }
+
+        void *allocateOrThrow(size_t size) {
+            void *ptr = allocate(size);
+            if (ptr == nullptr)
+                throw std::bad_alloc();
+
+            return ptr;
+        }
+#endif
+    } // namespace
+
+    MemoryScope::MemoryScope(MemTag tag) noexcept : previous(currentTag) {
+        currentTag = tag;
+    }
+
+    MemoryScope::~MemoryScope() {
+        currentTag = previous;
+    }
+
+    HeapUsage getHeapUsage(MemTag tag) noexcept {
+        const Counter &counter = heap[static_cast<size_t>(tag)];
+        return {counter.bytes.load(std::memory_order_relaxed), counter.peak.load(std::memory_order_relaxed),
+                counter.allocations.load(std::memory_order_relaxed)};
+    }
+
+    uint64_t getHeapBytes() noexcept {
+        uint64_t bytes = 0;
+        for (const Counter &counter : heap)
+            bytes += counter.bytes.load(std::memory_order_relaxed);
+
+        return bytes;
+    }
+
+    void trackSurface(const SDL_Surface *surf, bool alive) noexcept {
+        if (surf == nullptr)
+            return;
+
+        const auto bytes = static_cast<uint64_t>(surf->pitch) * static_cast<uint64_t>(surf->h);
+        if (alive) {
+            add(surfaces, bytes);
+            surfaceTotal.fetch_add(bytes, std::memory_order_relaxed);
+        } else {
+            sub(surfaces, bytes);
+        }
+    }
+
+    void MemoryReport::sample(SceneID scene, uint64_t textureBytes) {
+        if (scene == noScene)
+            return;
+
+        if (scene >= highWater.size())
+            highWater.resize(scene + 1, 0);
+
+        highWater[scene] = std::max(highWater[scene], getHeapBytes() + textureBytes);
+    }
+
+    std::basic_string<char> MemoryReport::toJson(Image &image, std::span<const std::string_view> sceneNames) const {
+        // resident textures by pixel format & by owner
+        std::map<std::basic_string<char>, uint64_t> formats;
+        uint64_t owners[static_cast<size_t>(MemTag::Count)] {};
+        uint64_t textureCount = 0;
+        image.getRegistry().forEach([&](ImageHandle, ImageData &data) {
+            uint32_t format = 0;
+            if (data.texture == nullptr ||
+                SDL_QueryTexture(data.texture.get(), &format, nullptr, nullptr, nullptr) != 0)
+                return;
+
+            formats[SDL_GetPixelFormatName(format)] += data.textureBytes;
+            owners[static_cast<size_t>(data.owner)] += data.textureBytes;
+            ++textureCount;
+        });
+
+        std::basic_string<char> json = "{\n  \"heap\": {";
+        for (size_t i = 0; i < std::size(tagNames); ++i) {
+            const HeapUsage usage = getHeapUsage(static_cast<MemTag>(i));
+            json += std::format("{}\n    \"{}\": {{\"bytes\": {}, \"peak\": {}, \"allocations\": {}}}",
+                                (i == 0) ? "" : ",", tagNames[i], usage.bytes, usage.peak, usage.allocations);
+        }
+
+        json += std::format("\n  }},\n  \"textures\": {{\n    \"count\": {},\n    \"bytes\": {},\n"
+                            "    \"layer_bytes\": {},\n",
+                            textureCount, image.getTextureBytes(), image.getLayerBytes());
+        json += "    \"by_format\": {";
+        bool first = true;
+        for (const auto &[name, bytes] : formats) {
+            json += std::format("{}\"{}\": {}", first ? "" : ", ", name, bytes);
+            first = false;
+        }
+
+        json += "},\n    \"by_owner\": {";
+        for (size_t i = 0; i < std::size(tagNames); ++i)
+            json += std::format("{}\"{}\": {}", (i == 0) ? "" : ", ", tagNames[i], owners[i]);
+
+        json += std::format("}}\n  }},\n  \"surfaces\": {{\"bytes\": {}, \"peak\": {}, \"total\": {}}},\n",
+                            surfaces.bytes.load(std::memory_order_relaxed),
+                            surfaces.peak.load(std::memory_order_relaxed),
+                            surfaceTotal.load(std::memory_order_relaxed));
+        json += std::format("  \"fonts\": {{\"count\": {}, \"file_size_bytes\": {}}},\n  \"scene_high_water\": {{",
+                            image.getFontCount(), image.getFontFileBytes());
+        for (size_t i = 0; i < highWater.size(); ++i) {
+            const std::string_view name = (i < sceneNames.size()) ? sceneNames[i] : std::string_view("unknown");
+            json += std::format("{}\"{}\": {}", (i == 0) ? "" : ", ", name, highWater[i]);
+        }
+        json += "}\n}\n";
+
+        return json;
+    }
+} // namespace Application::Helper
+
+// every heap allocation made through new is counted (the aligned forms are left to the standard library), the
+// benchmarks define ANYA_NO_HEAP_HOOKS so their timings do not include the header & the counters
+#ifndef ANYA_NO_HEAP_HOOKS
+void *operator new(size_t size) {
+    return Application::Helper::allocateOrThrow(size);
+}
+
+void *operator new[](size_t size) {
+    return Application::Helper::allocateOrThrow(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return Application::Helper::allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return Application::Helper::allocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    Application::Helper::deallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    Application::Helper::deallocate(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    Application::Helper::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    Application::Helper::deallocate(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    Application::Helper::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    Application::Helper::deallocate(ptr);
+}
+#endif
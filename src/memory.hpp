@@ -0,0 +1,82 @@
+#pragma once
+
+#include <SDL.h>
+#include "data.hpp"
+#include "image.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/** Structure
+ *
+ * Heap -> the global operator new/delete keep the size & tag of every block in a header in front of it, the tag
+ *         comes from the innermost MemoryScope on the thread (Other outside of any scope); left out of the
+ *         benchmarks (ANYA_NO_HEAP_HOOKS), where every heap figure stays 0
+ * Textures -> bytes per pixel format & per owner (image, animation, text) & the bytes of their CPU layers, read from
+ *             the image registry on demand
+ * Surfaces -> decoded & rendered surfaces only live until their texture is made, the live, peak & total bytes are kept
+ * Fonts -> open faces & the size of their files; FreeType allocates its faces & glyph caches with malloc, which is
+ *          not hooked, so that memory is in neither the heap figures nor file_size_bytes
+ * High-water -> heap + texture + layer bytes sampled once per frame, the largest value seen in every scene
+ */
+
+namespace Application::Helper {
+    // Charges the heap allocations made on this thread to a subsystem while it is alive
+    class MemoryScope final {
+    public:
+        explicit MemoryScope(MemTag tag) noexcept;
+        ~MemoryScope();
+        MemoryScope(const MemoryScope &) = delete;
+        MemoryScope &operator=(const MemoryScope &) = delete;
+
+    private:
+        MemTag previous;
+    };
+
+    struct HeapUsage final {
+        uint64_t bytes {0};
+        uint64_t peak {0};
+        // live blocks
+        uint64_t allocations {0};
+    };
+
+    /** Gets the heap memory charged to a subsystem.
+     *
+     * \param tag -> the subsystem
+     * \return the live bytes, the peak & the number of live blocks.
+     */
+    HeapUsage getHeapUsage(MemTag tag) noexcept;
+    /** Gets the heap memory of every subsystem.
+     *
+     * \return the live bytes on the heap (made through operator new).
+     */
+    uint64_t getHeapBytes() noexcept;
+    /** Counts a surface that was created or is about to be freed.
+     *
+     * \param surf -> the surface (nullptr is ignored)
+     * \param alive -> true when it was created, false when it is freed
+     */
+    void trackSurface(const SDL_Surface *surf, bool alive) noexcept;
+
+    class MemoryReport final {
+    public:
+        /** Updates the high-water mark of a scene, call it once per frame.
+         *
+         * \param scene -> the scene being shown
+         * \param textureBytes -> the texture memory in use, layers included (Image::getTextureBytes + getLayerBytes)
+         */
+        void sample(SceneID scene, uint64_t textureBytes);
+        /** Creates the memory report.
+         *
+         * \param image -> the images to account for
+         * \param sceneNames -> the scene names, indexed by scene ID
+         * \return the report as JSON.
+         */
+        std::basic_string<char> toJson(Image &image, std::span<const std::string_view> sceneNames) const;
+
+    private:
+        // indexed by scene ID
+        std::vector<uint64_t> highWater {};
+    };
+} // namespace Application::Helper
@@ -0,0 +1,123 @@
+#include "power.hpp"
+#include <algorithm>
+#include <fstream>
+#ifdef __linux__
+    #include <filesystem>
+#endif
+
+namespace Application::Helper {
+    namespace {
+        // frame rates that are never exceeded in a state (FPS)
+        constexpr double saverFPS = 15.0;
+        constexpr double unfocusedFPS = 10.0;
+        constexpr double unfocusedSaverFPS = 5.0;
+        constexpr auto batteryInterval = std::chrono::seconds(30);
+
+#ifdef __linux__
+        std::basic_string<char> readLine(const std::filesystem::path &path) {
+            std::ifstream file(path);
+            std::basic_string<char> line;
+            std::getline(file, line);
+
+            return line;
+        }
+
+        // on battery when there is a battery and no mains supply is online
+        bool readBattery() {
+            std::error_code ec;
+            bool hasBattery = false;
+            for (const auto &entry : std::filesystem::directory_iterator("/sys/class/power_supply", ec)) {
+                const std::basic_string<char> type = readLine(entry.path() / "type");
+                if (type == "Mains" && readLine(entry.path() / "online") == "1")
+                    return false;
+
+                if (type == "Battery")
+                    hasBattery = hasBattery || readLine(entry.path() / "status") == "Discharging";
+            }
+
+            return hasBattery;
+        }
+#else
+        bool readBattery() {
+            return SDL_GetPowerInfo(nullptr, nullptr) == SDL_POWERSTATE_ON_BATTERY;
+        }
+#endif
+    } // namespace
+
+    PowerProfile PowerPolicy::parseProfile(std::string_view name) noexcept {
+        if (name == "performance")
+            return PowerProfile::Performance;
+
+        if (name == "saver")
+            return PowerProfile::Saver;
+
+        return PowerProfile::Auto;
+    }
+
+    void PowerPolicy::setProfile(PowerProfile profile) noexcept {
+        this->profile = profile;
+    }
+
+    bool PowerPolicy::handleEvent(const SDL_WindowEvent &ev) noexcept {
+        const bool wasVisible = isVisible();
+        switch (ev.event) {
+            case SDL_WINDOWEVENT_MINIMIZED: {
+                minimized = true;
+            } break;
+
+            case SDL_WINDOWEVENT_HIDDEN: {
+                hidden = true;
+            } break;
+
+            case SDL_WINDOWEVENT_SHOWN: {
+                hidden = false;
+            } break;
+
+            case SDL_WINDOWEVENT_RESTORED:
+            case SDL_WINDOWEVENT_MAXIMIZED: {
+                minimized = false;
+                hidden = false;
+            } break;
+
+            case SDL_WINDOWEVENT_FOCUS_GAINED: {
+                focused = true;
+            } break;
+
+            case SDL_WINDOWEVENT_FOCUS_LOST: {
+                focused = false;
+            } break;
+        }
+
+        return !wasVisible && isVisible();
+    }
+
+    bool PowerPolicy::isVisible() const noexcept {
+        return !minimized && !hidden;
+    }
+
+    bool PowerPolicy::isFocused() const noexcept {
+        return focused;
+    }
+
+    bool PowerPolicy::onBattery() {
+        const auto now = std::chrono::steady_clock::now();
+        if (!batteryRead || now - batteryTime >= batteryInterval) {
+            battery = readBattery();
+            batteryRead = true;
+            batteryTime = now;
+        }
+
+        return battery;
+    }
+
+    double PowerPolicy::getFrameDelay(double delay) {
+        bool saver = profile == PowerProfile::Saver;
+        if (profile == PowerProfile::Auto)
+            saver = onBattery();
+
+        if (!focused)
+            return std::max(delay, 1000.0 / (saver ? unfocusedSaverFPS : unfocusedFPS));
+
+        return saver ? std::max(delay, 1000.0 / saverFPS) : delay;
+    }
+} // namespace Application::Helper
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <SDL.h>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+/** Structure
+ *
+ * Visibility -> minimized & hidden windows are not animated or drawn at all, the loop sleeps until the next event
+ * Focus -> an unfocused window is still drawn (the clock stays correct) but at a lower frame rate
+ * Resync -> the frame clock restarts when the window shows again, the time it was hidden is not animated
+ * Profile -> auto follows the power source (sysfs on linux, SDL elsewhere), performance & saver are fixed
+ */
+
+namespace Application::Helper {
+    enum class PowerProfile : uint8_t {
+        Auto,
+        Performance,
+        Saver,
+    };
+
+    class PowerPolicy final {
+    public:
+        /** Gets a power profile from its name.
+         *
+         * \param name -> auto, performance or saver
+         * \return the profile, Auto if the name is unknown.
+         */
+        static PowerProfile parseProfile(std::string_view name) noexcept;
+        /** Sets the power profile.
+         *
+         * \param profile -> the profile to follow
+         */
+        void setProfile(PowerProfile profile) noexcept;
+        /** Updates the window state.
+         *
+         * \param ev -> a window event (minimized, hidden, shown, restored, focus gained/lost)
+         * \return true if the window became visible again and the frame clock has to be resynced, otherwise false.
+         */
+        bool handleEvent(const SDL_WindowEvent &ev) noexcept;
+        /** Checks if the window can be seen (not minimized or hidden).
+         *
+         * \return true if visible, otherwise false.
+         */
+        bool isVisible() const noexcept;
+        /** Checks if the window has the input focus.
+         *
+         * \return true if focused, otherwise false.
+         */
+        bool isFocused() const noexcept;
+        /** Checks if the device runs on battery, the power source is read at most every 30 seconds.
+         *
+         * \return true if on battery, otherwise false (on AC or unknown).
+         */
+        bool onBattery();
+        /** Gets the time between frames for the current state.
+         *
+         * \param delay -> the frame time when focused (ms)
+         * \return the frame time to wait for (ms).
+         */
+        double getFrameDelay(double delay);
+
+    private:
+        PowerProfile profile {PowerProfile::Auto};
+        bool minimized {false};
+        bool hidden {false};
+        bool focused {true};
+        bool battery {false};
+        bool batteryRead {false};
+        std::chrono::steady_clock::time_point batteryTime {};
+    };
+} // namespace Application::Helper
@@ -0,0 +1,134 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+namespace Application::Helper {
+    namespace {
+        // events, animation, interface, text, draw, overlay, present (sleep is not drawn)
+        constexpr SDL_Color phaseColors[] = {
+            {235, 100, 90, 255},  {240, 190, 80, 255},  {120, 200, 110, 255}, {90, 190, 230, 255},
+            {150, 120, 230, 255}, {160, 160, 160, 255}, {230, 120, 200, 255},
+        };
+    } // namespace
+
+    void Profiler::setEnabled(bool enable) noexcept {
+        if (enable && !enabled) {
+            // start over, old frames would mix with the ones from before the pause
+            head = 0;
+            current = {};
+            last = Clock::now();
+            figuresTime = {};
+        }
+
+        enabled = enable;
+    }
+
+    bool Profiler::isEnabled() const noexcept {
+        return enabled;
+    }
+
+    void Profiler::lap(Phase phase) noexcept {
+        if (!enabled)
+            return;
+
+        const Clock::time_point now = Clock::now();
+        current.phases[static_cast<size_t>(phase)] += std::chrono::duration<float, std::milli>(now - last).count();
+        last = now;
+    }
+
+    void Profiler::endFrame() noexcept {
+        if (!enabled)
+            return;
+
+        current.busy = 0.0f;
+        for (size_t i = 0; i < current.phases.size(); ++i) {
+            if (i != static_cast<size_t>(Phase::Overlay) && i != static_cast<size_t>(Phase::Sleep))
+                current.busy += current.phases[i];
+        }
+
+        frames[head % capacity] = current;
+        ++head;
+
+        current = {};
+        last = Clock::now();
+    }
+
+    uint32_t Profiler::frameCount() const noexcept {
+        return std::min(head, capacity);
+    }
+
+    template <class F> float Profiler::percentile(float p, F &&value) const {
+        const uint32_t count = frameCount();
+        if (count == 0)
+            return 0.0f;
+
+        for (uint32_t i = 0; i < count; ++i)
+            scratch[i] = value(frames[i]);
+
+        // nearest rank
+        const auto rank = static_cast<uint32_t>(std::ceil(std::clamp(p, 0.0f, 1.0f) * static_cast<float>(count)));
+        const uint32_t nth = std::clamp<uint32_t>(rank, 1, count) - 1;
+        std::nth_element(scratch.begin(), scratch.begin() + nth, scratch.begin() + count);
+
+        return scratch[nth];
+    }
+
+    float Profiler::getPercentile(float p) const {
+        return percentile(p, [](const Frame &frame) { return frame.busy; });
+    }
+
+    float Profiler::getPhasePercentile(Phase phase, float p) const {
+        return percentile(p, [phase](const Frame &frame) { return frame.phases[static_cast<size_t>(phase)]; });
+    }
+
+    void Profiler::draw(SDL_Renderer *ren, Image &image, std::string_view fontFile) {
+        if (!enabled)
+            return;
+
+        int outputW = 0;
+        int outputH = 0;
+        if (SDL_GetRendererOutputSize(ren, &outputW, &outputH) != 0)
+            return;
+
+        // one pixel per frame, newest on the right
+        const int graphWidth = std::min(static_cast<int>(capacity), outputW - 4);
+        const SDL_Rect area = {2, outputH - graphHeight - 2, graphWidth, graphHeight};
+        if (graphWidth <= 0 || area.y < 0)
+            return;
+
+        batch.fillRect(area, {0, 0, 0, 160}, ren);
+
+        const uint32_t written = head;
+        const uint32_t shown = std::min(std::min(written, capacity), static_cast<uint32_t>(graphWidth));
+        for (uint32_t i = 0; i < shown; ++i) {
+            const Frame &frame = frames[(written - shown + i) % capacity];
+            const int x = area.x + graphWidth - static_cast<int>(shown) + static_cast<int>(i);
+
+            float top = static_cast<float>(area.y + area.h);
+            for (size_t phase = 0; phase < std::size(phaseColors); ++phase) {
+                const float height = frame.phases[phase] / graphRange * static_cast<float>(graphHeight);
+                const float bottom = top;
+                top = std::max(top - height, static_cast<float>(area.y));
+
+                const int y = static_cast<int>(std::lround(top));
+                const int h = static_cast<int>(std::lround(bottom)) - y;
+                if (h > 0)
+                    batch.fillRect({x, y, 1, h}, phaseColors[phase], ren);
+            }
+        }
+
+        batch.flush(ren);
+
+        const Clock::time_point now = Clock::now();
+        if (now - figuresTime >= figuresInterval) {
+            figuresTime = now;
+            const std::basic_string<char> text = std::format("p50 {:.1f} p95 {:.1f} p99 {:.1f}", getPercentile(0.50f),
+                                                             getPercentile(0.95f), getPercentile(0.99f));
+            figures = image.createText({text, std::basic_string<char>(fontFile), {{0}, {0}, {255, 255, 255, 255}}, 8},
+                                       ren, figures);
+        }
+
+        image.draw(figures, ren, area.x + 1, area.y + 1);
+    }
+} // namespace Application::Helper
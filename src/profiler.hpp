@@ -0,0 +1,105 @@
+#pragma once
+
+#include <SDL.h>
+#include "batch.hpp"
+#include "image.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/** Structure
+ *
+ * Phase -> the parts of a frame that are timed (events, animation, interface, text, drawing, overlay, present, sleep)
+ * Lap -> lap() charges the time since the previous lap to a phase, it is a single branch while the profiler is off
+ * Ring -> the last 256 frames, written & read by the main loop only (no locks, not safe to read from another thread)
+ * Overlay -> a stacked bar per frame (one colour per phase) & the p50/p95/p99 of the busy time; drawing the overlay
+ *            is its own phase, it shows in the graph but is left out of the busy time along with sleep
+ */
+
+namespace Application::Helper {
+    enum class Phase : uint8_t {
+        Events,
+        Animation,
+        Interface,
+        Text,
+        Draw,
+        // the profiler's own graph & figures
+        Overlay,
+        Present,
+        Sleep,
+        Count,
+    };
+
+    class Profiler final {
+    public:
+        /** Turns the profiler & its overlay on or off, nothing is timed while it is off.
+         *
+         * \param enable -> true to record frames, false to stop
+         */
+        void setEnabled(bool enable) noexcept;
+        /** Checks if the profiler is recording.
+         *
+         * \return true if frames are recorded, otherwise false.
+         */
+        bool isEnabled() const noexcept;
+        /** Charges the time since the previous lap (or the end of the last frame) to a phase.
+         *
+         * \param phase -> the phase that just finished
+         */
+        void lap(Phase phase) noexcept;
+        /** Stores the current frame in the ring buffer and starts the next one.
+         */
+        void endFrame() noexcept;
+        /** Gets a percentile of the busy time (every phase but sleep) over the recorded frames.
+         *
+         * \param p -> the percentile (0 to 1)
+         * \return the busy time (in ms) or 0 if no frame was recorded.
+         */
+        float getPercentile(float p) const;
+        /** Gets a percentile of a single phase over the recorded frames.
+         *
+         * \param phase -> the phase
+         * \param p -> the percentile (0 to 1)
+         * \return the time spent in the phase (in ms) or 0 if no frame was recorded.
+         */
+        float getPhasePercentile(Phase phase, float p) const;
+        /** Renders the frame graph & percentiles in the bottom left corner.
+         *
+         * \param ren -> the renderer to use
+         * \param image -> the images the figures are created with
+         * \param fontFile -> the font of the figures
+         */
+        void draw(SDL_Renderer *ren, Image &image, std::string_view fontFile);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Frame final {
+            std::array<float, static_cast<size_t>(Phase::Count)> phases {};
+            // every phase but overlay & sleep
+            float busy {0.0f};
+        };
+
+        template <class F> float percentile(float p, F &&value) const;
+        uint32_t frameCount() const noexcept;
+
+    private:
+        static constexpr uint32_t capacity = 256;
+        // one 30 FPS frame fills the graph
+        static constexpr float graphRange = 1000.0f / 30.0f;
+        static constexpr int graphHeight = 32;
+        // the figures are refreshed twice a second so they can be read
+        static constexpr std::chrono::milliseconds figuresInterval {500};
+
+        std::array<Frame, capacity> frames {};
+        // number of frames written, the newest is frames[(head - 1) % capacity]
+        uint32_t head {0};
+        Frame current {};
+        Clock::time_point last {};
+        bool enabled {false};
+        mutable std::array<float, capacity> scratch {};
+        Batch batch {};
+        ImageHandle figures {};
+        Clock::time_point figuresTime {};
+    };
+} // namespace Application::Helper
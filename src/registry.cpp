@@ -0,0 +1,111 @@
+#include "registry.hpp"
+#include "util.hpp"
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        constexpr uint32_t maxSlots = 1u << 20;
+        constexpr uint32_t maxGeneration = (1u << 12) - 1;
+    } // namespace
+
+    Registry::Registry() {
+        names.emplace_back();
+        nameHandles.emplace_back();
+        nameIds.insert({names.front(), 0});
+    }
+
+    uint32_t Registry::intern(std::string_view name) {
+        auto iter = nameIds.find(name);
+        if (iter != nameIds.end())
+            return iter->second;
+
+        const auto id = static_cast<uint32_t>(names.size());
+        names.emplace_back(name);
+        nameHandles.emplace_back();
+        nameIds.insert({names.back(), id});
+
+        return id;
+    }
+
+    ImageHandle Registry::create(std::string_view name) {
+        uint32_t index = 0;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (slots.size() >= maxSlots) {
+                println("Image registry is full");
+                return {};
+            }
+
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        Slot &slot = slots[index];
+        slot.data = {};
+        slot.data.name = intern(name);
+        slot.alive = true;
+        ++liveCount;
+
+        const ImageHandle handle {(slot.generation << 20) | index};
+        // the latest image created under a name is the one found by it
+        if (slot.data.name != 0)
+            nameHandles[slot.data.name] = handle;
+
+        return handle;
+    }
+
+    int Registry::release(ImageHandle handle) {
+        ImageData *data = get(handle);
+        if (data == nullptr) {
+            println("Failed to release image");
+            return -1;
+        }
+
+        if (nameHandles[data->name] == handle)
+            nameHandles[data->name] = {};
+
+        Slot &slot = slots[handle.index()];
+        slot.data = {};
+        slot.alive = false;
+        // skip generation 0 so a handle is never 0
+        slot.generation = (slot.generation == maxGeneration) ? 1 : slot.generation + 1;
+        freeSlots.emplace_back(handle.index());
+        --liveCount;
+
+        return 0;
+    }
+
+    ImageHandle Registry::find(std::string_view name) const {
+        auto iter = nameIds.find(name);
+        if (iter == nameIds.end())
+            return {};
+
+        return nameHandles[iter->second];
+    }
+
+    int Registry::assign(std::string_view name, ImageHandle handle) {
+        ImageData *data = get(handle);
+        if (data == nullptr)
+            return -1;
+
+        const uint32_t id = intern(name);
+        if (nameHandles[id] && nameHandles[id] != handle && get(nameHandles[id]) != nullptr)
+            return -1;
+
+        nameHandles[id] = handle;
+        data->name = id;
+
+        return 0;
+    }
+
+    std::string_view Registry::getName(uint32_t name) const noexcept {
+        return (name < names.size()) ? std::string_view(names[name]) : std::string_view();
+    }
+
+    size_t Registry::size() const noexcept {
+        return liveCount;
+    }
+} // namespace Application::Helper
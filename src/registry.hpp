@@ -0,0 +1,102 @@
+#pragma once
+
+#include "data.hpp"
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/** Structure
+ *
+ * Registry -> slot map of ImageData, addressed by 32-bit generational handles (ImageHandle)
+ * Slot -> the ImageData and the generation of the handle that currently owns it
+ * Name -> paths & nametags are interned once, a name can point at one handle (file images, packs); the lookup
+ *         keys are views of the interned strings, so a name is stored once & found without a copy
+ */
+
+namespace Application::Helper {
+    class Registry final {
+    public:
+        /* Registry Constructor; reserves name 0 as the empty name.
+         */
+        Registry();
+        /** Creates an empty image slot.
+         *
+         * \param name -> (optional) the nametag of the image, the image can then be found by it
+         * \return the handle of the new slot.
+         */
+        ImageHandle create(std::string_view name = {});
+        /** Releases an image slot and its texture. Every handle to it stops resolving.
+         *
+         * \param handle -> the image to release
+         * \return 0 if the operation succeeded, otherwise -1 if the handle was stale.
+         */
+        int release(ImageHandle handle);
+        /** Finds an image by its nametag (hashes the name, avoid it in per-frame code).
+         *
+         * \param name -> the nametag of the image
+         * \return the handle of the image or an empty handle if the name is not in use.
+         */
+        ImageHandle find(std::string_view name) const;
+        /** Points a nametag at an image.
+         *
+         * \param name -> the nametag to use
+         * \param handle -> the image that will be found by the nametag
+         * \return 0 if the operation succeeded, otherwise -1 if the name is already in use.
+         */
+        int assign(std::string_view name, ImageHandle handle);
+        /** Gets the interned string of a name.
+         *
+         * \param name -> the interned name (ImageData::name)
+         * \return the name string.
+         */
+        std::string_view getName(uint32_t name) const noexcept;
+        /** Resolves a handle (no hashing, an index and a generation compare).
+         *
+         * \param handle -> the image to resolve
+         * \return the image data or nullptr if the handle is stale.
+         */
+        ImageData *get(ImageHandle handle) noexcept {
+            const uint32_t index = handle.index();
+            if (index >= slots.size() || slots[index].generation != handle.generation() || !slots[index].alive)
+                return nullptr;
+
+            return &slots[index].data;
+        }
+        /** Calls a function for every live image.
+         *
+         * \param func -> callable taking (ImageHandle, ImageData &)
+         */
+        template <class F> void forEach(F &&func) {
+            for (uint32_t i = 0; i < slots.size(); ++i) {
+                if (slots[i].alive)
+                    func(ImageHandle {(slots[i].generation << 20) | i}, slots[i].data);
+            }
+        }
+        /** Gets the number of live images.
+         *
+         * \return the number of slots in use.
+         */
+        size_t size() const noexcept;
+
+    private:
+        uint32_t intern(std::string_view name);
+
+    private:
+        struct Slot final {
+            ImageData data {};
+            uint32_t generation {1};
+            bool alive {false};
+        };
+
+        std::vector<Slot> slots {};
+        std::vector<uint32_t> freeSlots {};
+        // interned names, the handle each name points to is kept at the same index
+        // (a deque never moves its strings, the views in nameIds stay valid)
+        std::deque<std::basic_string<char>> names {};
+        std::vector<ImageHandle> nameHandles {};
+        std::unordered_map<std::string_view, uint32_t> nameIds {};
+        size_t liveCount {0};
+    };
+} // namespace Application::Helper
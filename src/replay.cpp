@@ -0,0 +1,185 @@
+#include "replay.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <iostream>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        template <class T> void writeValue(std::ofstream &file, const T &value) {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        template <class T> bool readValue(std::ifstream &file, T &value) {
+            return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+    } // namespace
+
+    int Replay::record(std::string_view filePath) {
+        out.open(std::basic_string<char>(filePath), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            println("Failed to create the recording");
+            return -1;
+        }
+
+        const int64_t wallClock = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::system_clock::now().time_since_epoch())
+                                      .count();
+
+        out.write(magic, sizeof(magic));
+        writeValue(out, version);
+        writeValue(out, static_cast<uint32_t>(sizeof(SDL_Event)));
+        writeValue(out, wallClock);
+        recordStart = std::chrono::steady_clock::now();
+
+        return 0;
+    }
+
+    int Replay::load(std::string_view filePath) {
+        std::ifstream file(std::basic_string<char>(filePath), std::ios::binary);
+        if (!file) {
+            println("Failed to open the recording");
+            return -1;
+        }
+
+        char fileMagic[sizeof(magic)] {};
+        uint32_t fileVersion = 0;
+        uint32_t eventSize = 0;
+        file.read(fileMagic, sizeof(fileMagic));
+        if (!file || !std::equal(std::begin(magic), std::end(magic), fileMagic) || !readValue(file, fileVersion) ||
+            fileVersion != version || !readValue(file, eventSize) || eventSize != sizeof(SDL_Event) ||
+            !readValue(file, startTime)) {
+            // SDL_Event differs between SDL builds, a recording only replays on the build that made it
+            println("Not a recording of this build");
+            return -1;
+        }
+
+        entries.clear();
+        Entry entry {};
+        while (readValue(file, entry.time) && readValue(file, entry.ev))
+            entries.push_back(entry);
+
+        nextEntry = 0;
+        virtualTime = 0.0;
+        framesAfterLast = 0;
+        frameTimes.clear();
+        replaying = true;
+
+        return 0;
+    }
+
+    bool Replay::isRecording() const noexcept {
+        return out.is_open();
+    }
+
+    bool Replay::isReplaying() const noexcept {
+        return replaying;
+    }
+
+    void Replay::write(const SDL_Event &ev) {
+        if (!out.is_open())
+            return;
+
+        // these carry pointers that are gone by the time the file is replayed
+        if (ev.type == SDL_DROPFILE || ev.type == SDL_DROPTEXT || ev.type >= SDL_USEREVENT)
+            return;
+
+        const auto time = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - recordStart)
+                .count());
+        writeValue(out, time);
+        writeValue(out, ev);
+    }
+
+    bool Replay::poll(SDL_Event &ev) noexcept {
+        if (nextEntry >= entries.size() || static_cast<double>(entries[nextEntry].time) > virtualTime)
+            return false;
+
+        ev = entries[nextEntry++].ev;
+        return true;
+    }
+
+    void Replay::endFrame(double frameTime, double workTime) {
+        virtualTime += frameTime;
+        frameTimes.push_back(static_cast<float>(workTime));
+
+        if (nextEntry >= entries.size())
+            ++framesAfterLast;
+    }
+
+    bool Replay::isLastFrame() const noexcept {
+        return replaying && nextEntry >= entries.size() && framesAfterLast + 1 >= tailFrames;
+    }
+
+    bool Replay::isDone() const noexcept {
+        return replaying && nextEntry >= entries.size() && framesAfterLast >= tailFrames;
+    }
+
+    std::chrono::system_clock::time_point Replay::now() const noexcept {
+        if (!replaying)
+            return std::chrono::system_clock::now();
+
+        const auto elapsed = std::chrono::milliseconds(startTime + static_cast<int64_t>(virtualTime));
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed));
+    }
+
+    void Replay::setChecksum(uint64_t sum) noexcept {
+        lastChecksum = sum;
+    }
+
+    uint64_t Replay::checksum(SDL_Renderer *ren) {
+        int w = 0;
+        int h = 0;
+        if (SDL_GetRendererOutputSize(ren, &w, &h) != 0 || w <= 0 || h <= 0)
+            return 0;
+
+        std::vector<uint32_t> pixels(static_cast<size_t>(w) * static_cast<size_t>(h));
+        if (SDL_RenderReadPixels(ren, nullptr, SDL_PIXELFORMAT_ARGB8888, pixels.data(), w * 4) != 0) {
+            panicln("Failed to read the frame");
+            return 0;
+        }
+
+        return fnv1a(pixels.data(), pixels.size() * sizeof(uint32_t));
+    }
+
+    int Replay::report(std::string_view filePath) const {
+        std::vector<float> sorted = frameTimes;
+        std::sort(sorted.begin(), sorted.end());
+
+        // nearest rank
+        const auto percentile = [&sorted](float p) {
+            if (sorted.empty())
+                return 0.0f;
+            const auto rank = static_cast<size_t>(std::ceil(p * static_cast<float>(sorted.size())));
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        };
+
+        std::basic_string<char> json = std::format(
+            "{{\n  \"frames\": {},\n  \"events\": {},\n  \"checksum\": \"{:016x}\",\n"
+            "  \"frame_ms\": {{\"p50\": {:.3f}, \"p95\": {:.3f}, \"p99\": {:.3f}, \"max\": {:.3f}}},\n"
+            "  \"frame_times\": [",
+            frameTimes.size(), entries.size(), lastChecksum, percentile(0.50f), percentile(0.95f), percentile(0.99f),
+            sorted.empty() ? 0.0f : sorted.back());
+        for (size_t i = 0; i < frameTimes.size(); ++i)
+            json += std::format("{}{:.3f}", (i == 0) ? "" : ", ", frameTimes[i]);
+        json += "]\n}\n";
+
+        if (filePath.empty()) {
+            std::cout << json;
+            return 0;
+        }
+
+        std::ofstream file(std::basic_string<char>(filePath), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            println("Failed to write the replay report");
+            return -1;
+        }
+        file << json;
+
+        return 0;
+    }
+} // namespace Application::Helper
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <SDL.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** Structure
+ *
+ * Recording -> a header (magic, version, SDL_Event size, wall clock at the start) then one entry per event:
+ *              the time since the start (ms) & the raw SDL_Event, events holding pointers (drop, user) are skipped
+ * Replay -> the events are handed out by a virtual clock that advances one frame at a time, a replay runs the same
+ *           frames with the same events on every run, no matter how fast the machine is
+ * Clock -> the wall clock of a replay is the recorded start plus the virtual time, so the clock text is reproducible
+ * Report -> the work time of every frame (ms), its percentiles & a checksum (FNV-1a) of the last frame, as JSON
+ */
+
+namespace Application::Helper {
+    class Replay final {
+    public:
+        /** Starts recording the events handed to write().
+         *
+         * \param filePath -> the file to record to (replaced if it exists)
+         * \return 0 if the operation succeeded, otherwise -1 if the file could not be created.
+         */
+        int record(std::string_view filePath);
+        /** Loads a recording to replay.
+         *
+         * \param filePath -> the recorded file
+         * \return 0 if the operation succeeded, otherwise -1 if the file is missing or not a recording.
+         */
+        int load(std::string_view filePath);
+        /** Checks if events are being recorded.
+         *
+         * \return true if recording, otherwise false.
+         */
+        bool isRecording() const noexcept;
+        /** Checks if a recording is being replayed.
+         *
+         * \return true if replaying, otherwise false.
+         */
+        bool isReplaying() const noexcept;
+        /** Appends an event to the recording.
+         *
+         * \param ev -> the event that was polled
+         */
+        void write(const SDL_Event &ev);
+        /** Gets the next event that is due on the virtual clock, one per frame like the live loop.
+         *
+         * \param ev -> receives the event
+         * \return true if an event was due, otherwise false.
+         */
+        bool poll(SDL_Event &ev) noexcept;
+        /** Ends a replayed frame, the virtual clock advances by the frame time.
+         *
+         * \param frameTime -> the time a frame stands for (ms)
+         * \param workTime -> the time the frame really took (ms)
+         */
+        void endFrame(double frameTime, double workTime);
+        /** Checks if the next frame is the last one of the replay (take the checksum before presenting it).
+         *
+         * \return true if the frame about to be presented is the last one, otherwise false.
+         */
+        bool isLastFrame() const noexcept;
+        /** Checks if the replay is over (every event was handed out & the fades had time to settle).
+         *
+         * \return true if the replay is over, otherwise false.
+         */
+        bool isDone() const noexcept;
+        /** Gets the wall clock, the virtual one while replaying.
+         *
+         * \return the current time.
+         */
+        std::chrono::system_clock::time_point now() const noexcept;
+        /** Stores the checksum of the last frame for the report.
+         *
+         * \param sum -> the checksum
+         */
+        void setChecksum(uint64_t sum) noexcept;
+        /** Hashes the pixels of the current render target.
+         *
+         * \param ren -> the renderer to read from
+         * \return the FNV-1a hash of the ARGB8888 pixels or 0 if they could not be read.
+         */
+        static uint64_t checksum(SDL_Renderer *ren);
+        /** Writes the replay report.
+         *
+         * \param filePath -> the file to write the JSON to (stdout if empty)
+         * \return 0 if the operation succeeded, otherwise -1 if it failed.
+         */
+        int report(std::string_view filePath) const;
+
+    private:
+        struct Entry final {
+            // time since the start of the recording (ms)
+            uint64_t time {0};
+            SDL_Event ev {};
+        };
+
+    private:
+        static constexpr char magic[8] = {'A', 'N', 'Y', 'A', 'R', 'E', 'C', '1'};
+        static constexpr uint32_t version = 1;
+        // frames replayed after the last event so fades & animations settle
+        static constexpr uint32_t tailFrames = 30;
+
+        std::ofstream out {};
+        std::chrono::steady_clock::time_point recordStart {};
+
+        std::vector<Entry> entries {};
+        size_t nextEntry {0};
+        bool replaying {false};
+        // recorded wall clock at the start (ms since the epoch) & the virtual time since
+        int64_t startTime {0};
+        double virtualTime {0.0};
+        uint32_t framesAfterLast {0};
+        std::vector<float> frameTimes {};
+        uint64_t lastChecksum {0};
+    };
+} // namespace Application::Helper
@@ -1,10 +1,31 @@
 #pragma once
 
 #include <SDL.h>
+#include "data.hpp"
+#include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 
+/** Structure
+ *
+ * Scene -> the scene list (indexed by ID) & the current scene, change hooks run when it changes
+ * Manifest -> the assets of a scene, loaded on its first entry instead of at boot & released once it has not been
+ *             shown for the release delay (checked in update, so at the next frame or wake-up after it passed)
+ * Prefetch -> the scenes that usually follow the current one are loaded one per update after it is shown, the
+ *             renderer is single threaded so "background" means the frames after the switch, not another thread
+ */
+
 namespace Application::Helper {
+    struct SceneManifest final {
+        // makes the scene's assets resident, 0 if they were loaded
+        std::function<int()> load {};
+        // lets the assets go, load is called again on the next entry
+        std::function<void()> release {};
+        // scenes that usually follow (or are drawn under) this one, prefetched & kept while it is shown
+        std::vector<SceneID> next {};
+    };
+
     class Scene {
     public:
         /* Scene Destructor; clears out any scenes in the array when the object is destroyed.
@@ -12,41 +33,103 @@ namespace Application::Helper {
         constexpr ~Scene() { sceneList.clear(); }
         /** Creates new scenes to use as layers.
          *
+         * \param id -> the ID of the scene (scene IDs are small, they index the scene list)
          * \param name -> name of the scene to be created
+         * \return 0 if the operation succeeded, otherwise -1 if the ID is taken or the name is empty.
+         */
+        constexpr int createScene(SceneID id, std::string_view name);
+        /** Sets a created scene to be used as the current layer, the change hooks run if the scene changed.
+         *
+         * \param id -> ID of the scene to be set as current
+         * \return 0 if the operation succeeded, otherwise -1 if the scene was never created.
+         */
+        int setScene(SceneID id);
+        /** Adds a function that is called every time the current scene changes (not every frame).
+         *
+         * \param hook -> callable taking (SceneID previous, SceneID current)
+         */
+        void addChangeHook(std::function<void(SceneID, SceneID)> hook);
+        /** Sets the assets of a scene (nothing is loaded until the scene or one before it is shown).
+         *
+         * \param id -> ID of the scene
+         * \param manifest -> how to load & release the assets, and the scenes to prefetch after this one
+         * \return 0 if the operation succeeded, otherwise -1 if the scene was never created.
          */
-        constexpr void createScene(std::string_view name);
-        /** Sets a created scene to be used as the current layer.
+        int setManifest(SceneID id, SceneManifest manifest);
+        /** Sets how long a scene has to be unused before its assets are released.
          *
-         * \param name -> name of the scene to be set as current
+         * \param delay -> the time since the scene was last shown
          */
-        constexpr void setScene(std::string_view name);
+        void setReleaseDelay(std::chrono::milliseconds delay) noexcept;
+        /** Prefetches the next queued scene & releases the scenes unused for the release delay, call once a frame.
+         *
+         * \param now -> the current time
+         */
+        void update(std::chrono::steady_clock::time_point now);
+        /** Checks if scenes are still waiting to be prefetched (the loop should not sleep yet).
+         *
+         * \return true if a prefetch is queued, otherwise false.
+         */
+        bool isPrefetching() const noexcept;
+        /** Loads the assets of a scene now, for a scene that is drawn without being shown (under a menu).
+         *
+         * \param id -> ID of the scene
+         * \return 0 if the operation succeeded, otherwise -1 if the scene does not exist or its load failed.
+         */
+        int load(SceneID id);
+        /** Checks if the assets of a scene are loaded.
+         *
+         * \param id -> ID of the scene
+         * \return true if loaded (or the scene has no manifest), otherwise false.
+         */
+        bool isLoaded(SceneID id) const noexcept;
         /* Prints the current scene being shown, to the console.
          */
         constexpr void printScene();
         /** Retrieves the current scene being shown.
          *
-         * \return the current scene number.
+         * \return the current scene ID (noScene if none was set).
          */
-        constexpr uint64_t getCurrentScene();
+        constexpr SceneID getCurrentScene();
         /** Retrieves the current scene being shown.
          *
          * \return the current scene name.
          */
         constexpr std::string_view getCurrentSceneName();
-        /** Finds and returns the index of the scene being looked for.
-         *  This is primarily used to be compared against `getCurrentScene`.
-         *
-         *  Example: getCurrentScene() == findScene("Menu")
+        /** Finds the ID of a scene by its name (a linear search, avoid it in per-frame code).
          *
          * \param name -> name of the scene to find
-         * \return the scene index of the scene name.
+         * \return the scene ID or noScene if there is no scene with the name.
          */
-        constexpr uint64_t findScene(std::string_view name);
+        constexpr SceneID findScene(std::string_view name);
+        /** Checks if a scene was created.
+         *
+         * \param id -> ID of the scene
+         * \return true if the scene exists, otherwise false.
+         */
+        constexpr bool hasScene(SceneID id);
 
     private:
-        uint64_t currentScene;
+        // loads the assets of a scene if they are not, false if the load failed
+        bool loadScene(SceneID id);
+
+    private:
+        struct ManifestState final {
+            SceneManifest manifest {};
+            bool loaded {false};
+            // when the scene was last shown (or prefetched)
+            std::chrono::steady_clock::time_point lastShown {};
+        };
+
+        SceneID currentScene {noScene};
+        // indexed by scene ID, unused IDs have an empty name
         std::vector<std::basic_string<char>> sceneList;
+        std::vector<std::function<void(SceneID, SceneID)>> changeHooks;
+        // indexed by scene ID, scenes without a manifest are never loaded or released
+        std::vector<ManifestState> manifests;
+        std::vector<SceneID> prefetchQueue;
+        std::chrono::milliseconds releaseDelay {std::chrono::seconds(30)};
     };
 } // namespace Application::Helper
 
-#include "scene.inl"
\ No newline at end of file
+#include "scene.inl"
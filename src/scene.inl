@@ -4,37 +4,161 @@
 using namespace Application::Helper::Utils;
 
 namespace Application::Helper {
-    __forceinline constexpr void Scene::createScene(std::string_view name) {
-        sceneList.emplace_back(name);
+    inline constexpr int Scene::createScene(SceneID id, std::string_view name) {
+        if (id == noScene || name.empty() || hasScene(id)) {
+            println("Failed to create scene");
+            return -1;
+        }
+
+        if (id >= sceneList.size())
+            sceneList.resize(static_cast<size_t>(id) + 1);
+
+        sceneList[id] = name;
+
+        return 0;
     }
 
-    inline constexpr void Scene::setScene(std::string_view name) {
-        const auto it = std::find(sceneList.begin(), sceneList.end(), name);
-        const auto sceneIndex = it - sceneList.begin();
+    inline int Scene::setScene(SceneID id) {
+        if (!hasScene(id)) {
+            println("Failed to set scene, it does not exist");
+            return -1;
+        }
+
+        if (id == currentScene)
+            return 0;
 
-        currentScene = sceneIndex;
+        // the assets have to be there for the first frame, a failed load is retried on the next entry
+        loadScene(id);
+
+        const SceneID previous = currentScene;
+        currentScene = id;
+        if (previous < manifests.size())
+            manifests[previous].lastShown = std::chrono::steady_clock::now();
+
+        // the likely next scenes are loaded over the next frames
+        prefetchQueue.clear();
+        if (id < manifests.size()) {
+            for (const SceneID next : manifests[id].manifest.next) {
+                if (!isLoaded(next))
+                    prefetchQueue.emplace_back(next);
+            }
+        }
 
 #ifdef _DEBUG
         printScene();
 #endif
+
+        for (const auto &hook : changeHooks)
+            hook(previous, currentScene);
+
+        return 0;
     }
 
-    __forceinline constexpr void Scene::printScene() {
-        println(sceneList[currentScene]);
+    inline void Scene::addChangeHook(std::function<void(SceneID, SceneID)> hook) {
+        changeHooks.emplace_back(std::move(hook));
     }
 
-    __forceinline constexpr uint64_t Scene::getCurrentScene() {
+    inline int Scene::setManifest(SceneID id, SceneManifest manifest) {
+        if (!hasScene(id)) {
+            println("Failed to set manifest, the scene does not exist");
+            return -1;
+        }
+
+        if (id >= manifests.size())
+            manifests.resize(static_cast<size_t>(id) + 1);
+
+        manifests[id].manifest = std::move(manifest);
+        manifests[id].loaded = false;
+
+        return 0;
+    }
+
+    inline void Scene::setReleaseDelay(std::chrono::milliseconds delay) noexcept {
+        releaseDelay = delay;
+    }
+
+    inline void Scene::update(std::chrono::steady_clock::time_point now) {
+        // one scene per frame so a switch never waits on more than its own assets
+        if (!prefetchQueue.empty()) {
+            const SceneID id = prefetchQueue.front();
+            prefetchQueue.erase(prefetchQueue.begin());
+            if (loadScene(id))
+                manifests[id].lastShown = now;
+        }
+
+        // the current scene & the ones that follow it are kept
+        const std::vector<SceneID> *keep = (currentScene < manifests.size()) ? &manifests[currentScene].manifest.next
+                                                                              : nullptr;
+        for (SceneID id = 0; id < manifests.size(); ++id) {
+            ManifestState &state = manifests[id];
+            if (!state.loaded || id == currentScene || now - state.lastShown < releaseDelay)
+                continue;
+
+            if (keep != nullptr && std::find(keep->begin(), keep->end(), id) != keep->end())
+                continue;
+
+            if (state.manifest.release)
+                state.manifest.release();
+            state.loaded = false;
+        }
+    }
+
+    inline bool Scene::isPrefetching() const noexcept {
+        return !prefetchQueue.empty();
+    }
+
+    inline int Scene::load(SceneID id) {
+        if (!hasScene(id)) {
+            println("Failed to load scene, it does not exist");
+            return -1;
+        }
+
+        return loadScene(id) ? 0 : -1;
+    }
+
+    inline bool Scene::isLoaded(SceneID id) const noexcept {
+        return id >= manifests.size() || manifests[id].loaded || !manifests[id].manifest.load;
+    }
+
+    inline bool Scene::loadScene(SceneID id) {
+        if (isLoaded(id))
+            return true;
+
+        ManifestState &state = manifests[id];
+        if (state.manifest.load() != 0) {
+            println("Failed to load the scene's assets");
+            return false;
+        }
+        state.loaded = true;
+        state.lastShown = std::chrono::steady_clock::now();
+
+        return true;
+    }
+
+    inline constexpr void Scene::printScene() {
+        println(getCurrentSceneName());
+    }
+
+    inline constexpr SceneID Scene::getCurrentScene() {
         return currentScene;
     }
 
-    __forceinline constexpr std::string_view Scene::getCurrentSceneName() {
-        return sceneList[currentScene];
+    inline constexpr std::string_view Scene::getCurrentSceneName() {
+        return hasScene(currentScene) ? std::string_view(sceneList[currentScene]) : std::string_view();
     }
 
-    inline constexpr uint64_t Scene::findScene(std::string_view name) {
+    inline constexpr SceneID Scene::findScene(std::string_view name) {
+        if (name.empty())
+            return noScene;
+
         const auto it = std::find(sceneList.begin(), sceneList.end(), name);
-        const auto sceneIndex = it - sceneList.begin();
+        if (it == sceneList.end())
+            return noScene;
+
+        return static_cast<SceneID>(it - sceneList.begin());
+    }
 
-        return sceneIndex;
+    inline constexpr bool Scene::hasScene(SceneID id) {
+        return id < sceneList.size() && !sceneList[id].empty();
     }
-} // namespace Application::Helper
\ No newline at end of file
+} // namespace Application::Helper
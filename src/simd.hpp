@@ -0,0 +1,54 @@
+#pragma once
+
+// SSE2 is part of x86-64 and is assumed there, 32-bit builds need /arch:SSE2 (msvc) or -msse2
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ANYA_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define ANYA_SSE2 0
+#endif
+
+// AVX2 is not assumed, its kernels are compiled for it on their own and only called after cpuHasAvx2()
+#if ANYA_SSE2
+    #define ANYA_AVX2 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define ANYA_AVX2_TARGET
+    #else
+        #define ANYA_AVX2_TARGET __attribute__((target("avx2")))
+    #endif
+#else
+    #define ANYA_AVX2 0
+    #define ANYA_AVX2_TARGET
+#endif
+
+namespace Application::Helper {
+    // Checks if the CPU (and the OS, for the wider registers) supports AVX2, read once
+    inline bool cpuHasAvx2() noexcept {
+#if !ANYA_AVX2
+        return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        static const bool supported = [] {
+            int info[4] {};
+            __cpuidex(info, 0, 0);
+            if (info[0] < 7)
+                return false;
+
+            // osxsave & avx, then the os has to save the ymm registers
+            __cpuidex(info, 1, 0);
+            if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+                return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+        }();
+
+        return supported;
+#else
+        static const bool supported = __builtin_cpu_supports("avx2");
+
+        return supported;
+#endif
+    }
+} // namespace Application::Helper
@@ -0,0 +1,163 @@
+#include "trace.hpp"
+#include "util.hpp"
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <vector>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        struct Event final {
+            const char *name {nullptr};
+            // 'X' slice, 's' flow start, 'f' flow end
+            char phase {'X'};
+            // 1 main thread, 2 input latency
+            uint8_t track {1};
+            int64_t ts {0};
+            int64_t dur {0};
+            uint64_t flow {0};
+        };
+
+        struct Pending final {
+            const char *name {nullptr};
+            int64_t ts {0};
+            uint64_t flow {0};
+        };
+
+        // a frame adds about ten events, a million is over an hour at 30 FPS
+        constexpr size_t maxEvents = 1 << 20;
+
+        bool enabled = false;
+        std::basic_string<char> outFile {};
+        std::chrono::steady_clock::time_point origin {};
+        std::vector<Event> events {};
+        std::vector<Pending> pending {};
+        uint64_t nextFlow = 1;
+
+        void push(const Event &event) {
+            if (events.size() < maxEvents)
+                events.push_back(event);
+        }
+
+        const char *inputName(uint32_t type) noexcept {
+            switch (type) {
+                case SDL_MOUSEBUTTONDOWN:
+                    return "mouse down";
+                case SDL_MOUSEBUTTONUP:
+                    return "mouse up";
+                case SDL_MOUSEMOTION:
+                    return "mouse motion";
+                case SDL_KEYDOWN:
+                    return "key down";
+                case SDL_KEYUP:
+                    return "key up";
+                case SDL_TEXTINPUT:
+                    return "text input";
+                default:
+                    return nullptr;
+            }
+        }
+    } // namespace
+
+    TraceScope::TraceScope(const char *name) noexcept : name(name) {
+        if (enabled)
+            start = traceNow();
+    }
+
+    TraceScope::~TraceScope() {
+        // the trace may have stopped while the scope was open
+        if (start < 0 || !enabled)
+            return;
+
+        push({name, 'X', 1, start, traceNow() - start, 0});
+    }
+
+    void traceStart(std::string_view filePath) {
+        outFile = filePath;
+        origin = std::chrono::steady_clock::now();
+        events.clear();
+        events.reserve(4096);
+        pending.clear();
+        enabled = true;
+    }
+
+    int traceStop() {
+        if (!enabled)
+            return 0;
+        enabled = false;
+
+        std::ofstream file(outFile, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            println("Failed to write the trace");
+            return -1;
+        }
+
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        // track names
+        file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, "
+                "\"args\": {\"name\": \"main\"}},\n";
+        file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, "
+                "\"args\": {\"name\": \"input latency\"}}";
+        for (const Event &event : events) {
+            file << std::format(",\n{{\"name\": \"{}\", \"cat\": \"anya\", \"ph\": \"{}\", "
+                                "\"pid\": 1, \"tid\": {}, \"ts\": {}",
+                                event.name, event.phase, event.track, event.ts);
+            if (event.phase == 'X')
+                file << std::format(", \"dur\": {}", event.dur);
+            else
+                file << std::format(", \"id\": {}{}", event.flow, (event.phase == 'f') ? ", \"bp\": \"e\"" : "");
+            file << '}';
+        }
+        file << "\n]}\n";
+
+        if (events.size() >= maxEvents)
+            println("Trace was full, later events were dropped");
+
+        events.clear();
+        events.shrink_to_fit();
+        pending.clear();
+
+        return 0;
+    }
+
+    bool traceEnabled() noexcept {
+        return enabled;
+    }
+
+    void traceInput(const SDL_Event &ev) {
+        if (!enabled)
+            return;
+
+        const char *name = inputName(ev.type);
+        if (name == nullptr)
+            return;
+
+        // a short slice for the flow to start from
+        const int64_t now = traceNow();
+        const uint64_t flow = nextFlow++;
+        push({name, 'X', 1, now, 1, 0});
+        push({name, 's', 1, now, 0, flow});
+        pending.push_back({name, now, flow});
+    }
+
+    void tracePresent(int64_t presentStart) {
+        if (!enabled || pending.empty())
+            return;
+
+        const int64_t now = traceNow();
+        for (const Pending &input : pending) {
+            push({input.name, 'f', 1, presentStart, 0, input.flow});
+            push({input.name, 'X', 2, input.ts, now - input.ts, 0});
+        }
+        pending.clear();
+    }
+
+    int64_t traceNow() noexcept {
+        if (!enabled)
+            return -1;
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+} // namespace Application::Helper
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/** Structure
+ *
+ * Trace -> scoped markers written as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev), main thread only
+ * Scope -> a complete ("X") event from construction to destruction, nothing is read while tracing is off
+ * Flow -> every input event starts a flow that ends on the present that first shows it (the next one),
+ *         the time between the two is also recorded as a "latency" slice on a track of its own
+ * Limit -> at most maxEvents are kept in memory, later ones are dropped
+ */
+
+namespace Application::Helper {
+    class TraceScope final {
+    public:
+        /* TraceScope Constructor; starts a slice.
+         *
+         * \param name -> name of the slice (a string literal, it is kept until the trace is written)
+         */
+        explicit TraceScope(const char *name) noexcept;
+        /* TraceScope Destructor; ends the slice.
+         */
+        ~TraceScope();
+        TraceScope(const TraceScope &) = delete;
+        TraceScope &operator=(const TraceScope &) = delete;
+
+    private:
+        const char *name;
+        int64_t start {-1};
+    };
+
+    /** Starts collecting trace events.
+     *
+     * \param filePath -> the file the trace is written to by traceStop
+     */
+    void traceStart(std::string_view filePath);
+    /** Writes the trace & stops collecting.
+     *
+     * \return 0 if the operation succeeded, otherwise -1 if the trace could not be written.
+     */
+    int traceStop();
+    /** Checks if trace events are collected.
+     *
+     * \return true if tracing, otherwise false.
+     */
+    bool traceEnabled() noexcept;
+    /** Starts a flow for an input event (mouse, keyboard & text input, other events are ignored).
+     *
+     * \param ev -> the event that was polled
+     */
+    void traceInput(const SDL_Event &ev);
+    /** Ends the flows of every input since the last present, call it right after SDL_RenderPresent.
+     *
+     * \param presentStart -> when the present began (from traceNow)
+     */
+    void tracePresent(int64_t presentStart);
+    /** Gets the trace clock.
+     *
+     * \return the time since the trace started (in µs) or -1 if tracing is off.
+     */
+    int64_t traceNow() noexcept;
+} // namespace Application::Helper
@@ -0,0 +1,116 @@
+#include "transition.hpp"
+#include "trace.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    Transition::Transition(Image &image) : image(image) {}
+
+    int Transition::start(SDL_Renderer *ren, int w, int h, TransitionStyle transitionStyle, double transitionTime,
+                          const std::function<void()> &drawFrom, const std::function<void()> &drawTo) {
+        TraceScope scope("transition");
+        active = false;
+        if (transitionStyle == TransitionStyle::Cut || transitionTime <= 0.0)
+            return 0;
+
+        // the snapshots are kept for the next transition unless the window size changed
+        if (!from || !to || size.x != w || size.y != h) {
+            if (from)
+                image.remove(from);
+            if (to)
+                image.remove(to);
+
+            from = image.createRenderTarget(ren, static_cast<unsigned int>(w), static_cast<unsigned int>(h));
+            to = image.createRenderTarget(ren, static_cast<unsigned int>(w), static_cast<unsigned int>(h));
+            if (!from || !to)
+                return -1;
+            size = {w, h};
+        }
+
+        if (snapshot(ren, from, drawFrom) != 0 || snapshot(ren, to, drawTo) != 0)
+            return -1;
+
+        // the incoming scene fades in over the outgoing one
+        SDL_SetTextureBlendMode(image.getTexture(to, ren), (transitionStyle == TransitionStyle::Fade)
+                                                               ? SDL_BLENDMODE_BLEND
+                                                               : SDL_BLENDMODE_NONE);
+        style = transitionStyle;
+        duration = transitionTime;
+        elapsed = 0.0;
+        fresh = true;
+        active = true;
+
+        return 0;
+    }
+
+    void Transition::update(double dt) noexcept {
+        if (!active)
+            return;
+
+        if (fresh) {
+            fresh = false;
+            return;
+        }
+
+        elapsed += dt;
+        if (elapsed >= duration)
+            active = false;
+    }
+
+    void Transition::draw(SDL_Renderer *ren) {
+        SDL_Texture *fromTexture = image.getTexture(from, ren);
+        SDL_Texture *toTexture = image.getTexture(to, ren);
+        if (fromTexture == nullptr || toTexture == nullptr)
+            return;
+
+        const float t = ease(Easing::QuadInOut, static_cast<float>(std::min(elapsed / duration, 1.0)));
+        SDL_Rect fromDst {0, 0, size.x, size.y};
+        SDL_Rect toDst {0, 0, size.x, size.y};
+        const int offset = static_cast<int>(std::lround(t * static_cast<float>(size.x)));
+
+        switch (style) {
+            case TransitionStyle::Fade: {
+                SDL_SetTextureAlphaMod(toTexture, static_cast<uint8_t>(std::lround(t * 255.0f)));
+            } break;
+
+            case TransitionStyle::SlideLeft: {
+                fromDst.x = -offset;
+                toDst.x = size.x - offset;
+            } break;
+
+            case TransitionStyle::SlideRight: {
+                fromDst.x = offset;
+                toDst.x = offset - size.x;
+            } break;
+
+            default:
+                break;
+        }
+
+        SDL_RenderCopy(ren, fromTexture, nullptr, &fromDst);
+        SDL_RenderCopy(ren, toTexture, nullptr, &toDst);
+    }
+
+    bool Transition::isActive() const noexcept {
+        return active;
+    }
+
+    int Transition::snapshot(SDL_Renderer *ren, ImageHandle target, const std::function<void()> &drawScene) {
+        SDL_Texture *texture = image.getTexture(target, ren);
+        SDL_Texture *previous = SDL_GetRenderTarget(ren);
+        if (texture == nullptr || SDL_SetRenderTarget(ren, texture) != 0) {
+            panicln("Failed to snapshot the scene");
+            return -1;
+        }
+
+        SDL_SetRenderDrawColor(ren, 0, 0, 0, 255);
+        SDL_RenderClear(ren);
+        drawScene();
+        SDL_SetRenderTarget(ren, previous);
+
+        return 0;
+    }
+} // namespace Application::Helper
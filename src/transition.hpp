@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SDL.h>
+#include "image.hpp"
+#include "tween.hpp"
+#include <functional>
+
+/** Structure
+ *
+ * Transition -> blends the outgoing scene into the incoming one instead of cutting between them
+ * Snapshot -> both scenes are drawn once, when the transition starts, into two render targets (created on the first
+ *             transition & reused), every frame after that only copies the two cached textures
+ * Style -> cross-fade (the incoming scene fades in over the outgoing one) or slide (both move by the window width)
+ * Clock -> the frame a transition starts in is not counted, a long idle wait before the click would end it at once
+ */
+
+namespace Application::Helper {
+    enum class TransitionStyle : uint8_t {
+        Cut,
+        Fade,
+        // the incoming scene comes in from the right
+        SlideLeft,
+        // the incoming scene comes in from the left
+        SlideRight,
+    };
+
+    class Transition final {
+    public:
+        /** Transition Constructor; the snapshots are render targets in the image registry.
+         *
+         * \param image -> the images to create the snapshots in
+         */
+        explicit Transition(Image &image);
+        /** Snapshots both scenes & starts blending them, a Cut only stops a running transition.
+         *
+         * \param ren -> the renderer to use
+         * \param w -> the width of the scenes
+         * \param h -> the height of the scenes
+         * \param style -> how the scenes are blended
+         * \param duration -> how long the transition takes (in ms)
+         * \param drawFrom -> draws the outgoing scene (into the current render target)
+         * \param drawTo -> draws the incoming scene (into the current render target)
+         * \return 0 if the operation succeeded, otherwise -1 if the snapshots failed to be created (no transition).
+         */
+        int start(SDL_Renderer *ren, int w, int h, TransitionStyle style, double duration,
+                  const std::function<void()> &drawFrom, const std::function<void()> &drawTo);
+        /** Advances the transition.
+         *
+         * \param dt -> deltaTime from the main loop (in ms)
+         */
+        void update(double dt) noexcept;
+        /** Draws the two snapshots at the current progress.
+         *
+         * \param ren -> the renderer to use
+         */
+        void draw(SDL_Renderer *ren);
+        /** Checks if a transition is running (the scenes should not be drawn).
+         *
+         * \return true if running, otherwise false.
+         */
+        bool isActive() const noexcept;
+
+    private:
+        // draws a scene into a snapshot, the render target is restored afterwards
+        int snapshot(SDL_Renderer *ren, ImageHandle target, const std::function<void()> &drawScene);
+
+    private:
+        Image &image;
+        ImageHandle from {};
+        ImageHandle to {};
+        SDL_Point size {0, 0};
+        TransitionStyle style {TransitionStyle::Cut};
+        double duration {0.0};
+        double elapsed {0.0};
+        // started this frame, its deltaTime is skipped
+        bool fresh {false};
+        bool active {false};
+    };
+} // namespace Application::Helper
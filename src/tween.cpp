@@ -0,0 +1,78 @@
+#include "tween.hpp"
+#include <algorithm>
+
+namespace Application::Helper {
+    float ease(Easing easing, float t) noexcept {
+        t = std::clamp(t, 0.0f, 1.0f);
+
+        switch (easing) {
+            case Easing::Linear:
+                return t;
+            case Easing::QuadIn:
+                return t * t;
+            case Easing::QuadOut:
+                return t * (2.0f - t);
+            case Easing::QuadInOut:
+                return (t < 0.5f) ? 2.0f * t * t : 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+            case Easing::CubicOut: {
+                const float inv = 1.0f - t;
+                return 1.0f - inv * inv * inv;
+            }
+        }
+
+        return t;
+    }
+
+    float Tween::value(Active &tween, float t) noexcept {
+        tween.current = tween.from + (tween.to - tween.from) * ease(tween.easing, t);
+        return tween.current;
+    }
+
+    Tween::Active *Tween::find(uint32_t key) noexcept {
+        auto iter = std::find_if(active.begin(), active.end(), [key](const Active &tween) { return tween.key == key; });
+        return (iter != active.end()) ? &*iter : nullptr;
+    }
+
+    void Tween::start(uint32_t key, float from, float to, double duration, Easing easing) {
+        Active *tween = find(key);
+        if (tween == nullptr) {
+            tween = &active.emplace_back();
+            tween->key = key;
+            tween->current = from;
+        }
+
+        tween->from = tween->current;
+        tween->to = to;
+        tween->easing = easing;
+        tween->elapsed = 0.0;
+        tween->duration = std::max(duration, 0.0);
+    }
+
+    void Tween::stop(uint32_t key) noexcept {
+        Active *tween = find(key);
+        if (tween == nullptr)
+            return;
+
+        *tween = active.back();
+        active.pop_back();
+    }
+
+    bool Tween::isActive(uint32_t key) const noexcept {
+        return std::any_of(active.begin(), active.end(), [key](const Active &tween) { return tween.key == key; });
+    }
+
+    bool Tween::empty() const noexcept {
+        return active.empty();
+    }
+
+    double Tween::nextCompletion() const noexcept {
+        double next = -1.0;
+        for (const auto &tween : active) {
+            const double left = std::max(tween.duration - tween.elapsed, 0.0);
+            if (next < 0.0 || left < next)
+                next = left;
+        }
+
+        return next;
+    }
+} // namespace Application::Helper
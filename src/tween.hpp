@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Structure
+ *
+ * Tween -> moves float values towards a target over time with an easing curve, keyed by a 32-bit ID
+ * Active -> only in-flight tweens are stored (compact list), a finished tween is swapped out & forgotten
+ * Apply -> update() hands every moved value to a callable, the owner decides where the value goes
+ * Sleep -> nextCompletion() tells the main loop how long until the nearest tween ends (or that none run)
+ */
+
+namespace Application::Helper {
+    enum class Easing : uint8_t {
+        Linear,
+        QuadIn,
+        QuadOut,
+        QuadInOut,
+        CubicOut,
+    };
+
+    /** Applies an easing curve.
+     *
+     * \param easing -> the curve to use
+     * \param t -> progress of the tween (0 to 1)
+     * \return the eased progress (0 to 1).
+     */
+    float ease(Easing easing, float t) noexcept;
+
+    class Tween final {
+    public:
+        /** Starts (or retargets) a tween, a running tween with the same key continues from its current value.
+         *
+         * \param key -> ID of the tween (a button ID, an element index, ...)
+         * \param from -> the value to start from (ignored if the key is already running)
+         * \param to -> the value to end at
+         * \param duration -> how long the tween takes (in ms)
+         * \param easing -> the easing curve to use
+         */
+        void start(uint32_t key, float from, float to, double duration, Easing easing = Easing::QuadOut);
+        /** Stops a tween where it is.
+         *
+         * \param key -> ID of the tween
+         */
+        void stop(uint32_t key) noexcept;
+        /** Advances every running tween and retires the ones that finished.
+         *
+         * \param dt -> deltaTime from the main loop (in ms)
+         * \param apply -> callable taking (uint32_t key, float value), called for every tween that moved
+         */
+        template <class F> void update(double dt, F &&apply) {
+            for (size_t i = 0; i < active.size();) {
+                Active &tween = active[i];
+                tween.elapsed += dt;
+
+                const bool done = tween.elapsed >= tween.duration;
+                const float t = done ? 1.0f : static_cast<float>(tween.elapsed / tween.duration);
+                apply(tween.key, value(tween, t));
+
+                if (done) {
+                    active[i] = active.back();
+                    active.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+        }
+        /** Checks if a tween is running.
+         *
+         * \param key -> ID of the tween
+         * \return true if the tween is in flight, otherwise false.
+         */
+        bool isActive(uint32_t key) const noexcept;
+        /** Checks if any tween is running.
+         *
+         * \return true if nothing is in flight, otherwise false.
+         */
+        bool empty() const noexcept;
+        /** Gets the time until the nearest tween finishes.
+         *
+         * \return the time left (in ms) or a negative value if no tween is running.
+         */
+        double nextCompletion() const noexcept;
+
+    private:
+        struct Active final {
+            uint32_t key {0};
+            Easing easing {Easing::Linear};
+            float from {0.0f};
+            float to {0.0f};
+            // the value last handed out, a retargeted tween starts from it
+            float current {0.0f};
+            double elapsed {0.0};
+            double duration {0.0};
+        };
+
+        static float value(Active &tween, float t) noexcept;
+        Active *find(uint32_t key) noexcept;
+
+    private:
+        std::vector<Active> active {};
+    };
+} // namespace Application::Helper
@@ -1,61 +1,168 @@
 #include "uinterface.hpp"
+#include "memory.hpp"
 #include "util.hpp"
+#include <algorithm>
+#include <cmath>
 
 using namespace Application::Helper::Utils;
 
 namespace Application::Helper {
-    BUTTONPTR UInterface::createButton(std::string_view text, std::string_view layerName, IMD texture, int x, int y,
-                                       uint32_t w, uint32_t h) {
-        BUTTONPTR newButton = std::make_shared<Button>();
+    UInterface::UInterface(Image &image) : image(image) {}
 
-        newButton->box = {x, y, static_cast<int>(w), static_cast<int>(h)};
-        newButton->text = text;
+    ButtonID UInterface::createButton(std::string_view text, SceneID layer, ImageHandle texture, int x, int y,
+                                      uint32_t w, uint32_t h) {
+        const ButtonID button = createButton(text, layer, x, y, w, h);
+        textures[button] = texture;
 
-        if (texture != nullptr)
-            newButton->texture = *texture;
+        return button;
+    }
+
+    ButtonID UInterface::createButton(std::string_view text, SceneID layer, int x, int y, uint32_t w, uint32_t h) {
+        MemoryScope scope(MemTag::Interface);
+        const auto button = static_cast<ButtonID>(rects.size());
 
-        newButton->layer = layerName;
+        rects.push_back({x, y, static_cast<int>(w), static_cast<int>(h)});
+        alphas.emplace_back(restAlpha);
+        flags.emplace_back(0);
+        themeIndices.emplace_back(0);
+        textures.emplace_back();
+        buttonLayers.emplace_back(layer);
+        texts.emplace_back(text);
+        labels.emplace_back();
+        labelKeys.emplace_back(0);
+        labelSizes.push_back({0, 0});
 
-        btnList.emplace_back(newButton);
+        addToLayer(button);
 
-        return newButton;
+        return button;
     }
 
-    BUTTONPTR UInterface::createButton(std::string_view text, std::string_view layerName, int x, int y, uint32_t w,
-                                       uint32_t h) {
-        BUTTONPTR newButton = std::make_shared<Button>();
+    void UInterface::addToLayer(ButtonID button) {
+        const SceneID layer = buttonLayers[button];
+        if (layer == noScene)
+            return;
 
-        newButton->box = {x, y, static_cast<int>(w), static_cast<int>(h)};
-        newButton->text = text;
-        newButton->layer = layerName;
+        if (layer >= layers.size())
+            layers.resize(static_cast<size_t>(layer) + 1);
 
-        btnList.emplace_back(newButton);
+        Layer &grid = layers[layer];
+        grid.buttons.emplace_back(button);
+        grid.dirty = true;
 
-        return newButton;
+        setFlag(button, ButtonEnabled, layer == activeLayer);
     }
 
-    std::vector<BUTTONPTR> &UInterface::getButtonList() {
-        return btnList;
+    void UInterface::markDirty(ButtonID button) {
+        if (buttonLayers[button] < layers.size())
+            layers[buttonLayers[button]].dirty = true;
     }
 
-    SDL_Point &UInterface::getMousePos() {
-        return mousePos;
+    void UInterface::rebuild(Layer &grid) {
+        MemoryScope scope(MemTag::Interface);
+        // cover the hit area and anything a button reaches past it
+        int width = hitArea.x;
+        int height = hitArea.y;
+        for (ButtonID button : grid.buttons) {
+            const SDL_Rect &box = rects[button];
+            width = std::max(width, box.x + box.w + 1);
+            height = std::max(height, box.y + box.h + 1);
+        }
+
+        grid.cols = (width + cellSize - 1) / cellSize;
+        grid.rows = (height + cellSize - 1) / cellSize;
+        const size_t cellCount = static_cast<size_t>(grid.cols) * grid.rows;
+
+        // count the buttons in each cell, then place them (cursorInBounds includes the right & bottom edge)
+        grid.cellStart.assign(cellCount + 1, 0);
+        auto forCells = [&grid](const SDL_Rect &box, auto &&func) {
+            const int x0 = std::max(box.x, 0) / cellSize;
+            const int y0 = std::max(box.y, 0) / cellSize;
+            const int x1 = std::min((box.x + box.w) / cellSize, grid.cols - 1);
+            const int y1 = std::min((box.y + box.h) / cellSize, grid.rows - 1);
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x)
+                    func(static_cast<size_t>(y) * grid.cols + x);
+            }
+        };
+
+        for (ButtonID button : grid.buttons)
+            forCells(rects[button], [&grid](size_t cell) { ++grid.cellStart[cell + 1]; });
+
+        for (size_t i = 0; i < cellCount; ++i)
+            grid.cellStart[i + 1] += grid.cellStart[i];
+
+        grid.cellItems.resize(grid.cellStart[cellCount]);
+        std::vector<uint32_t> fill(grid.cellStart.begin(), grid.cellStart.end() - 1);
+        for (ButtonID button : grid.buttons)
+            forCells(rects[button], [&](size_t cell) { grid.cellItems[fill[cell]++] = button; });
+
+        grid.dirty = false;
     }
 
-    void UInterface::setButtonTexture(BUTTONPTR &button, IMD &texture) {
-        button->texture = *texture;
+    void UInterface::query(const SDL_Point &pos, std::vector<ButtonID> &out) {
+        out.clear();
+        if (activeLayer >= layers.size() || pos.x < 0 || pos.y < 0)
+            return;
+
+        Layer &grid = layers[activeLayer];
+        if (grid.dirty)
+            rebuild(grid);
+
+        const int x = pos.x / cellSize;
+        const int y = pos.y / cellSize;
+        if (x >= grid.cols || y >= grid.rows)
+            return;
+
+        const size_t cell = static_cast<size_t>(y) * grid.cols + x;
+        for (uint32_t i = grid.cellStart[cell]; i < grid.cellStart[cell + 1]; ++i) {
+            const ButtonID button = grid.cellItems[i];
+            if (cursorInBounds(button, pos))
+                out.emplace_back(button);
+        }
     }
 
-    bool UInterface::cursorInBounds(BUTTONPTR &button, SDL_Point &mousePos) {
-        if (mousePos.x >= button->box.x && mousePos.x <= (button->box.x + button->box.w) &&
-            mousePos.y >= button->box.y && mousePos.y <= (button->box.y + button->box.h)) {
-            return true;
+    void UInterface::setHitArea(int w, int h) {
+        hitArea = {w, h};
+        for (auto &grid : layers)
+            grid.dirty = true;
+    }
+
+    void UInterface::setActiveLayer(SceneID layer) {
+        if (activeLayer < layers.size()) {
+            for (ButtonID button : layers[activeLayer].buttons)
+                setFlag(button, ButtonEnabled, false);
         }
 
-        return false;
+        activeLayer = layer;
+        if (activeLayer < layers.size()) {
+            for (ButtonID button : layers[activeLayer].buttons)
+                setFlag(button, ButtonEnabled, true);
+        }
+
+        // the old layer's buttons fade back to normal
+        query(mousePos, underCursor);
+        setHovered(underCursor);
+    }
+
+    const std::vector<ButtonID> &UInterface::getButtonsAt(const SDL_Point &pos) {
+        query(pos, hitList);
+
+        return hitList;
+    }
+
+    size_t UInterface::getButtonCount() const noexcept {
+        return rects.size();
     }
 
-    bool UInterface::cursorInBounds(SDL_Rect &area, SDL_Point &mousePos) {
+    SDL_Point &UInterface::getMousePos() {
+        return mousePos;
+    }
+
+    bool UInterface::cursorInBounds(ButtonID button, const SDL_Point &mousePos) const noexcept {
+        return cursorInBounds(rects[button], mousePos);
+    }
+
+    bool UInterface::cursorInBounds(const SDL_Rect &area, const SDL_Point &mousePos) const noexcept {
         if (mousePos.x >= area.x && mousePos.x <= (area.x + area.w) && mousePos.y >= area.y &&
             mousePos.y <= (area.y + area.h)) {
             return true;
@@ -64,26 +171,107 @@ namespace Application::Helper {
         return false;
     }
 
-    // make the text in the button independent
-    void UInterface::setButtonTextSize(IMD &buttonText, int w, int h) {
-        if (buttonText != nullptr) {
-            buttonText->imageWidth = w;
-            buttonText->imageHeight = h;
+    const SDL_Rect &UInterface::getButtonRect(ButtonID button) const noexcept {
+        return rects[button];
+    }
+
+    const ColorData &UInterface::getButtonTheme(ButtonID button) const noexcept {
+        return themes[themeIndices[button]];
+    }
+
+    std::basic_string<char> &UInterface::getButtonText(ButtonID button) noexcept {
+        return texts[button];
+    }
+
+    float UInterface::getButtonAlpha(ButtonID button) const noexcept {
+        return alphas[button];
+    }
+
+    bool UInterface::hasFlag(ButtonID button, ButtonFlags flag) const noexcept {
+        return (flags[button] & flag) != 0;
+    }
+
+    void UInterface::setFlag(ButtonID button, ButtonFlags flag, bool enable) noexcept {
+        if (enable)
+            flags[button] |= flag;
+        else
+            flags[button] &= static_cast<uint8_t>(~flag);
+    }
+
+    void UInterface::setButtonTexture(ButtonID button, ImageHandle texture) {
+        textures[button] = texture;
+    }
+
+    void UInterface::setLabelFont(std::string_view fontFile) {
+        labelFont = fontFile;
+        std::fill(labelKeys.begin(), labelKeys.end(), 0);
+    }
+
+    size_t UInterface::getButtonThemeIndex(ButtonID button) const noexcept {
+        return themeIndices[button];
+    }
+
+    void UInterface::setPalette(size_t theme, const ColorData &color) noexcept {
+        if (theme >= themes.size())
+            return;
+
+        themes[theme] = color;
+    }
+
+    void UInterface::setButtonTheme(ButtonID button, const ColorData &color) {
+        MemoryScope scope(MemTag::Interface);
+        auto same = [](const SDL_Color &a, const SDL_Color &b) {
+            return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+        };
+
+        // buttons mostly share a handful of themes, store each one once
+        for (size_t i = 0; i < themes.size(); ++i) {
+            if (same(themes[i].outlineColor, color.outlineColor) && same(themes[i].bgColor, color.bgColor) &&
+                same(themes[i].textColor, color.textColor)) {
+                themeIndices[button] = static_cast<uint16_t>(i);
+                return;
+            }
+        }
+
+        if (themes.size() > UINT16_MAX) {
+            println("Too many button themes");
+            return;
         }
+
+        themeIndices[button] = static_cast<uint16_t>(themes.size());
+        themes.emplace_back(color);
+    }
+
+    void UInterface::setButtonPos(ButtonID button, int x, int y) {
+        rects[button].x = x;
+        rects[button].y = y;
+        markDirty(button);
     }
 
-    void UInterface::setButtonTheme(BUTTONPTR &button, ColorData color) {
-        button->buttonColor = color;
+    void UInterface::setButtonSize(ButtonID button, uint32_t w, uint32_t h) {
+        rects[button].w = w;
+        rects[button].h = h;
+        markDirty(button);
     }
 
-    void UInterface::setButtonPos(BUTTONPTR &button, int x, int y) {
-        button->box.x = x;
-        button->box.y = y;
+    void UInterface::fade(ButtonID button, float to) {
+        // a fade that is cut short keeps the same speed
+        const double distance = std::abs(to - alphas[button]) / (SDL_ALPHA_OPAQUE - restAlpha);
+        tweens.start(button, alphas[button], to, fadeTime * distance, Easing::QuadOut);
     }
 
-    void UInterface::setButtonSize(BUTTONPTR &button, uint32_t w, uint32_t h) {
-        button->box.w = w;
-        button->box.h = h;
+    void UInterface::setHovered(const std::vector<ButtonID> &buttons) {
+        for (ButtonID button : hovered) {
+            if (std::find(buttons.begin(), buttons.end(), button) == buttons.end())
+                fade(button, restAlpha);
+        }
+
+        for (ButtonID button : buttons) {
+            if (std::find(hovered.begin(), hovered.end(), button) == hovered.end())
+                fade(button, SDL_ALPHA_OPAQUE);
+        }
+
+        hovered = buttons;
     }
 
     void UInterface::update(SDL_Event *ev, double dt) {
@@ -91,77 +279,130 @@ namespace Application::Helper {
             case SDL_MOUSEMOTION: {
                 mousePos.x = ev->motion.x;
                 mousePos.y = ev->motion.y;
+                query(mousePos, underCursor);
+                setHovered(underCursor);
             } break;
         }
 
-        for (auto &button : getButtonList()) {
-            if (cursorInBounds(button, getMousePos())) {
-                button->colorAlpha += 0.35f * static_cast<float>(dt);
-                if (button->colorAlpha >= SDL_ALPHA_OPAQUE)
-                    button->colorAlpha = SDL_ALPHA_OPAQUE;
-            } else {
-                button->colorAlpha -= 0.35f * static_cast<float>(dt);
-                if (button->colorAlpha <= 191.25f)
-                    button->colorAlpha = 191.25f;
-            }
-        }
+        tweens.update(dt, [this](uint32_t button, float alpha) { alphas[button] = alpha; });
+    }
+
+    double UInterface::nextTweenCompletion() const noexcept {
+        return tweens.nextCompletion();
     }
 
     void UInterface::drawDivider(const SDL_Rect &rect, const SDL_Color &col, SDL_Renderer *ren) {
-        SDL_SetRenderDrawColor(ren, col.r, col.g, col.b, col.a);
-        SDL_RenderDrawRect(ren, &rect);
+        batch.drawRect(rect, col, ren);
     }
 
     void UInterface::drawGradientEx(float x1, float y1, float x2, float y2, const SDL_Color &initial, const SDL_Color &end, SDL_Renderer *ren) {
-        SDL_Vertex vert[4] = {
-            {x1, y1, initial}, // top left
-            {x2, y1, initial}, // top right
-            {x1, y2, end}, // bottom left
-            {x2, y2, end}, // bottom right
-        };
-
-        const int indices[] = {0, 1, 3, 0, 2, 3};
-
-        SDL_RenderGeometry(ren, nullptr, vert, 4, indices, 6);
+        batch.drawGradient(x1, y1, x2, y2, initial, end, ren);
     }
 
     void UInterface::drawGradient(const SDL_FRect &rect, SDL_Color &initial, SDL_Color &end, SDL_Renderer *ren) {
         drawGradientEx(rect.x, rect.y, rect.w, rect.h, initial, end, ren);
     }
 
-    void UInterface::draw(BUTTONPTR &button, IMD buttonText, SDL_Renderer *ren, double scaleX, double scaleY) {
-        SDL_Rect dst = {button->box.x, button->box.y, button->box.w, button->box.h};
-        SDL_Rect textDst = {};
-        if (buttonText != nullptr) {
-            textDst = {button->box.x - (buttonText->imageWidth / 2), button->box.y - (buttonText->imageHeight / 2),
-                       button->box.w + buttonText->imageWidth,
-                       button->box.h + buttonText->imageHeight}; // modify the text dimensions here
+    int UInterface::flush(SDL_Renderer *ren) {
+        const int result = batch.flush(ren);
+
+        // labels are laid out again if the window moved to a display with another scale
+        int outputW = 0;
+        int outputH = 0;
+        int windowW = 0;
+        int windowH = 0;
+        SDL_Window *window = SDL_RenderGetWindow(ren);
+        if (window != nullptr && SDL_GetRendererOutputSize(ren, &outputW, &outputH) == 0) {
+            SDL_GetWindowSize(window, &windowW, &windowH);
+            if (windowH > 0)
+                labelScale = static_cast<float>(outputH) / static_cast<float>(windowH);
+        }
+
+        return result;
+    }
+
+    void UInterface::layoutLabel(ButtonID button, SDL_Renderer *ren) {
+        const SDL_Rect &box = rects[button];
+        const std::basic_string<char> &text = texts[button];
+        const float maxWidth = static_cast<float>(box.w - 2 * labelPadding) * labelScale;
+        const float maxHeight = static_cast<float>(box.h) * labelScale;
+
+        // fonts are opened at 72 dpi, so the point size is the em size in pixels
+        int fontSize = std::max(static_cast<int>(maxHeight * labelFill), 1);
+        TTF_Font *font = image.getFont(labelFont, fontSize);
+        if (font == nullptr)
+            return;
+
+        // shrink the text that does not fit, long labels are limited by the width
+        int textW = 0;
+        int textH = 0;
+        if (TTF_SizeText(font, text.c_str(), &textW, &textH) == 0 && textW > 0 && textH > 0) {
+            const float fit = std::min(maxWidth / static_cast<float>(textW), maxHeight / static_cast<float>(textH));
+            if (fit < 1.0f)
+                fontSize = std::max(static_cast<int>(static_cast<float>(fontSize) * fit), 1);
         }
 
+        // white glyphs, the text colour is applied when drawn
+        const MessageData msg {text, labelFont, {{0}, {0}, {255, 255, 255, 255}}, fontSize};
+        labels[button] = image.createText(msg, ren, labels[button]);
+
+        const SDL_Point size = image.getSize(labels[button]);
+        labelSizes[button] = {static_cast<int>(std::lround(static_cast<float>(size.x) / labelScale)),
+                              static_cast<int>(std::lround(static_cast<float>(size.y) / labelScale))};
+    }
+
+    Batch &UInterface::getBatch() noexcept {
+        return batch;
+    }
+
+    void UInterface::draw(ButtonID button, SDL_Renderer *ren, double scaleX, double scaleY) {
+        const SDL_Rect &box = rects[button];
+        SDL_Rect dst = box;
+
         if ((scaleX && scaleY) != 0) {
             dst.w *= static_cast<int>(scaleX);
             dst.h *= static_cast<int>(scaleY);
         }
 
+        const auto alpha = static_cast<uint8_t>(alphas[button]);
+        const ColorData &theme = themes[themeIndices[button]];
+
         // button background colour
-        SDL_SetRenderDrawColor(ren, button->buttonColor.bgColor.r, button->buttonColor.bgColor.g,
-                               button->buttonColor.bgColor.b, (uint8_t)button->colorAlpha);
-        SDL_RenderFillRect(ren, &dst);
+        const SDL_Color &bg = theme.bgColor;
+        batch.fillRect(dst, {bg.r, bg.g, bg.b, alpha}, ren);
 
-        SDL_Rect innerOutline = {button->box.x - 1, button->box.y - 1, button->box.w + 2, button->box.h + 2};
-        SDL_SetRenderDrawColor(ren, button->buttonColor.outlineColor.r, button->buttonColor.outlineColor.g,
-                               button->buttonColor.outlineColor.b, (uint8_t)button->colorAlpha);
-        SDL_RenderDrawRect(ren, &innerOutline);
+        const SDL_Color &outline = theme.outlineColor;
+        const SDL_Rect innerOutline = {box.x - 1, box.y - 1, box.w + 2, box.h + 2};
+        batch.drawRect(innerOutline, {outline.r, outline.g, outline.b, alpha}, ren);
 
-        SDL_Rect outerOutline = {button->box.x - 2, button->box.y - 2, button->box.w + 4, button->box.h + 4};
-        SDL_SetRenderDrawColor(ren, button->buttonColor.outlineColor.r, button->buttonColor.outlineColor.g,
-                               button->buttonColor.outlineColor.b, (uint8_t)button->colorAlpha);
-        SDL_RenderDrawRect(ren, &outerOutline);
+        const SDL_Rect outerOutline = {box.x - 2, box.y - 2, box.w + 4, box.h + 4};
+        batch.drawRect(outerOutline, {outline.r, outline.g, outline.b, alpha}, ren);
 
-        SDL_RenderCopy(ren, button->texture.texture.get(), nullptr, &dst);
+        const SDL_Color &tint = theme.textColor;
+        if (textures[button]) {
+            image.setTextureColor(textures[button], {tint.r, tint.g, tint.b, alpha});
+            SDL_Texture *icon = image.getTexture(textures[button], ren);
+            batch.drawTexture(icon, nullptr, dst, ren, image.getLayer(textures[button], ren));
+        }
 
-        if (buttonText != nullptr) {
-            SDL_RenderCopy(ren, buttonText->texture.get(), nullptr, &textDst);
+        const std::basic_string<char> &text = texts[button];
+        if (text.empty() || labelFont.empty())
+            return;
+
+        // render the label again only if what it shows changed
+        uint64_t key = fnv1a(text.data(), text.size());
+        key = fnv1a(&box.w, sizeof(box.w), key);
+        key = fnv1a(&box.h, sizeof(box.h), key);
+        key = fnv1a(&labelScale, sizeof(labelScale), key);
+        if (key != labelKeys[button]) {
+            layoutLabel(button, ren);
+            labelKeys[button] = key;
         }
+
+        const SDL_Point &size = labelSizes[button];
+        const SDL_Rect textDst = {box.x + (box.w - size.x) / 2, box.y + (box.h - size.y) / 2, size.x, size.y};
+        image.setTextureColor(labels[button], {tint.r, tint.g, tint.b, 255});
+        SDL_Texture *label = image.getTexture(labels[button], ren);
+        batch.drawTexture(label, nullptr, textDst, ren, image.getLayer(labels[button], ren));
     }
 } // namespace Application::Helper
\ No newline at end of file
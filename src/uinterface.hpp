@@ -1,55 +1,76 @@
 #pragma once
 
 #include <SDL.h>
+#include "batch.hpp"
 #include "data.hpp"
+#include "image.hpp"
+#include "tween.hpp"
 #include <string>
 #include <vector>
 
+/** Structure
+ *
+ * Buttons -> parallel arrays indexed by ButtonID (rects, alphas, flags, theme indices, textures, layers),
+ *            the hot loops only read the arrays they need, text is kept apart since it is rarely touched
+ * Themes -> palette of ColorData, every distinct theme is stored once & buttons keep an index into it,
+ *           setPalette recolours every button using an entry
+ * Labels -> button text is rendered white at the size it is shown (box height * output scale), centered in the box,
+ *           the text image is kept until the text, box or scale changes
+ * Tint -> labels & icons are alpha masks tinted with the text colour when drawn, a palette change rebuilds nothing
+ * Layer -> the buttons of one scene, only the active layer is enabled & hit-tested
+ * Grid -> uniform grid over a layer (sized to the window), each cell lists the buttons overlapping it
+ * Hover -> entering or leaving a button starts a tween on its alpha, only in-flight tweens are updated
+ * Drawing -> buttons, dividers & gradients go into a Batch, call flush before drawing over them & presenting
+ */
+
 namespace Application::Helper {
-    struct Button {
-        SDL_Rect box {0};
-        ImageData texture {};
-        ColorData buttonColor {};
-        // 75% of 255
-        float colorAlpha {191.25f};
-        std::basic_string<char> text {};
-        std::basic_string<char> layer {};
-        bool canMinimize {false};
-        bool canQuit {false};
-        bool isEnabled {false};
-    };
+    // Index of a button, buttons are never removed so an ID stays valid for the lifetime of the UInterface
+    using ButtonID = uint32_t;
+    // Button that is never created, used for "no button"
+    inline constexpr ButtonID noButton = UINT32_MAX;
 
-    using BUTTONPTR = std::shared_ptr<Button>;
+    enum ButtonFlags : uint8_t {
+        ButtonEnabled = 1 << 0,
+        ButtonCanMinimize = 1 << 1,
+        ButtonCanQuit = 1 << 2,
+    };
 
     class UInterface final {
     public:
+        /** UInterface Constructor; button textures & text are resolved through the image registry.
+         *
+         * \param image -> the images the buttons draw with
+         */
+        explicit UInterface(Image &image);
         /** Create a button with a texture.
          *
          * \param text -> the text within the button
-         * \param texture -> texture of the button
+         * \param layer -> the scene the button is shown in
+         * \param texture -> texture of the button (a white icon, tinted with the text colour)
          * \param x -> x position of the button
          * \param y -> y position of the button
          * \param w -> width of the button
          * \param h -> height of the button
-         * \return button object filled with all of the essential details for a customized button.
+         * \return the ID of the new button.
          */
-        BUTTONPTR createButton(std::string_view text, std::string_view layerName, IMD texture, int x, int y, uint32_t w,
-                               uint32_t h);
+        ButtonID createButton(std::string_view text, SceneID layer, ImageHandle texture, int x, int y, uint32_t w,
+                              uint32_t h);
         /** Create a normal button.
          *
          * \param text -> the text within the button
+         * \param layer -> the scene the button is shown in
          * \param x -> x position of the button
          * \param y -> y position of the button
          * \param w -> width of the button
          * \param h -> height of the button
-         * \return button object filled with all of the essential details for a customized button.
+         * \return the ID of the new button.
          */
-        BUTTONPTR createButton(std::string_view text, std::string_view layerName, int x, int y, uint32_t w, uint32_t h);
-        /** Gets all of the buttons created.
+        ButtonID createButton(std::string_view text, SceneID layer, int x, int y, uint32_t w, uint32_t h);
+        /** Gets the number of buttons created (IDs go from 0 to the count).
          *
-         * \return an std::vector of all of the buttons in the application.
+         * \return the number of buttons in the application.
          */
-        std::vector<BUTTONPTR> &getButtonList();
+        size_t getButtonCount() const noexcept;
         /** Gets the mouse's position in the application.
          *
          * \return the position of the mouse.
@@ -61,21 +82,63 @@ namespace Application::Helper {
          * \param mousePos -> cursor position
          * \return true if the cursor is inside of the button, otherwise false.
          */
-        bool cursorInBounds(BUTTONPTR &button, SDL_Point &mousePos);
+        bool cursorInBounds(ButtonID button, const SDL_Point &mousePos) const noexcept;
         /** Checks if the cursor is inside of a rectangle
          *
          * \param area -> the rectangle to check
          * \param mousePos -> cursor position
          * \return true if the cursor is inside of the rectangle, otherwise false.
          */
-        bool cursorInBounds(SDL_Rect &area, SDL_Point &mousePos);
-        /** Changes the text size in a button
+        bool cursorInBounds(const SDL_Rect &area, const SDL_Point &mousePos) const noexcept;
+        /** Gets the area of a button.
+         *
+         * \param button -> the button
+         * \return the position & size of the button.
+         */
+        const SDL_Rect &getButtonRect(ButtonID button) const noexcept;
+        /** Gets the colours of a button.
+         *
+         * \param button -> the button
+         * \return the outline, background & text colour of the button.
+         */
+        const ColorData &getButtonTheme(ButtonID button) const noexcept;
+        /** Gets the palette entry a button is drawn with.
+         *
+         * \param button -> the button
+         * \return the index of the button's theme in the palette.
+         */
+        size_t getButtonThemeIndex(ButtonID button) const noexcept;
+        /** Gets the text of a button, it can be edited in place (text input).
+         *
+         * \param button -> the button
+         * \return the text within the button.
+         */
+        std::basic_string<char> &getButtonText(ButtonID button) noexcept;
+        /** Gets the hover alpha of a button (191.25 at rest, 255 fully hovered).
+         *
+         * \param button -> the button
+         * \return the alpha of the button.
+         */
+        float getButtonAlpha(ButtonID button) const noexcept;
+        /** Checks a flag of a button.
+         *
+         * \param button -> the button
+         * \param flag -> the flag to check (ButtonFlags)
+         * \return true if the flag is set, otherwise false.
+         */
+        bool hasFlag(ButtonID button, ButtonFlags flag) const noexcept;
+        /** Sets or clears a flag of a button.
+         *
+         * \param button -> the button to modify
+         * \param flag -> the flag to change (ButtonFlags)
+         * \param enable -> true to set the flag, false to clear it
+         */
+        void setFlag(ButtonID button, ButtonFlags flag, bool enable) noexcept;
+        /** Sets the font the button labels are drawn with.
          *
-         * \param buttonText -> the text to modify
-         * \param w -> new width of the text
-         * \param h -> new height of the text
+         * \param fontFile -> the font file
          */
-        void setButtonTextSize(IMD &buttonText, int w, int h);
+        void setLabelFont(std::string_view fontFile);
         /** Changes the button colours (theme).
          *
          * \param button -> the button to modify
@@ -84,33 +147,63 @@ namespace Application::Helper {
          * \param - bgColor -> the background colour of the button
          * \param - textColor -> the text colour of the button
          */
-        void setButtonTheme(BUTTONPTR &button, ColorData color);
+        void setButtonTheme(ButtonID button, const ColorData &color);
+        /** Changes a palette entry, every button using it is drawn with the new colours.
+         *  Labels & icons are tinted when drawn, so no texture is rendered again.
+         *
+         * \param theme -> the palette entry to change (from getButtonThemeIndex)
+         * \param color -> the new outline, background & text colour
+         */
+        void setPalette(size_t theme, const ColorData &color) noexcept;
         /** Sets a button at the specified position.
          *
          * \param button -> the button being moved
          * \param x -> x position the button will move to
          * \param y -> y position the button will move to
          */
-        void setButtonPos(BUTTONPTR &button, int x, int y);
+        void setButtonPos(ButtonID button, int x, int y);
         /** Changes the size of a button.
          *
          * \param button -> the button to modify
          * \param w -> new width of a button
          * \param h -> new height of a button
          */
-        void setButtonSize(BUTTONPTR &button, uint32_t w, uint32_t h);
+        void setButtonSize(ButtonID button, uint32_t w, uint32_t h);
         /** Changes the texture of a button.
          *
          * \param button -> the button to modify
          * \param texture -> the new texture of the button
          */
-        void setButtonTexture(BUTTONPTR &button, IMD &texture);
+        void setButtonTexture(ButtonID button, ImageHandle texture);
+        /** Sets the area the hit-test grids cover (usually the window size), buttons outside of it grow the grid.
+         *
+         * \param w -> width of the area
+         * \param h -> height of the area
+         */
+        void setHitArea(int w, int h);
+        /** Sets the layer (scene) whose buttons are enabled, hit-tested & hovered.
+         *  Only the buttons of the old and new layer are touched, call it when the scene changes.
+         *
+         * \param layer -> the layer to use
+         */
+        void setActiveLayer(SceneID layer);
+        /** Gets the buttons of the active layer under a position.
+         *
+         * \param pos -> the position to test
+         * \return the buttons under the position, valid until the next call.
+         */
+        const std::vector<ButtonID> &getButtonsAt(const SDL_Point &pos);
         /** Updates the mouse position and button state.
          *
          * \param ev -> the events to poll
          * \param dt -> deltaTime from the main loop
          */
         void update(SDL_Event *ev, double dt);
+        /** Gets the time until the nearest button fade finishes.
+         *
+         * \return the time left (in ms) or a negative value if nothing is fading.
+         */
+        double nextTweenCompletion() const noexcept;
         /** Renders a divider to the screen.
          *
          * \param rect -> the divider (rectangle) to draw
@@ -137,18 +230,87 @@ namespace Application::Helper {
          * \param ren -> the renderer to use
          */
         void drawGradient(const SDL_FRect &rect, SDL_Color &initial, SDL_Color &end, SDL_Renderer *ren);
-        /** Renders a button to the screen
+        /** Submits the buttons, dividers & gradients drawn since the last flush, once per frame.
+         *  The output scale (high DPI) used for the labels is read here.
+         *
+         * \param ren -> the renderer to use
+         * \return 0 if the operation succeeded, otherwise -1 if it failed.
+         */
+        int flush(SDL_Renderer *ren);
+        /** Gets the batch the interface draws with (to draw immediately or count renderer calls).
+         *
+         * \return the interface batch.
+         */
+        Batch &getBatch() noexcept;
+        /** Renders a button & its label to the screen
          *
          * \param button -> the button to draw
-         * \param buttonText -> text to draw on the button (can be nullptr)
          * \param ren -> the renderer to use
          * \param sx -> scale the image's width up (0 by default)
          * \param sy -> scale the image's height up (0 by default)
          */
-        void draw(BUTTONPTR &button, IMD buttonText, SDL_Renderer *ren, double sx = 0.0, double sy = 0.0);
+        void draw(ButtonID button, SDL_Renderer *ren, double sx = 0.0, double sy = 0.0);
 
     private:
-        std::vector<BUTTONPTR> btnList;
+        struct Layer final {
+            // the buttons on the layer
+            std::vector<ButtonID> buttons {};
+            // cell i holds cellItems[cellStart[i]] up to cellItems[cellStart[i + 1]]
+            std::vector<uint32_t> cellStart {};
+            std::vector<ButtonID> cellItems {};
+            int cols {0};
+            int rows {0};
+            bool dirty {true};
+        };
+
+        void addToLayer(ButtonID button);
+        void markDirty(ButtonID button);
+        void rebuild(Layer &grid);
+        void query(const SDL_Point &pos, std::vector<ButtonID> &out);
+        void setHovered(const std::vector<ButtonID> &buttons);
+        void fade(ButtonID button, float to);
+        void layoutLabel(ButtonID button, SDL_Renderer *ren);
+
+    private:
+        // 16x16 cells, the main window is 10x6 cells
+        static constexpr int cellSize = 16;
+        // 75% of 255
+        static constexpr float restAlpha = 191.25f;
+        // time a full fade takes (ms)
+        static constexpr double fadeTime = 180.0;
+        // label point size as a part of the box height (the line height is about 1.2x the point size)
+        static constexpr float labelFill = 0.8f;
+        // space kept free on the left & right of a label
+        static constexpr int labelPadding = 2;
+
+        Image &image;
+        Batch batch {};
+        // button arrays, all the same length
+        std::vector<SDL_Rect> rects {};
+        std::vector<float> alphas {};
+        std::vector<uint8_t> flags {};
+        std::vector<uint16_t> themeIndices {};
+        std::vector<ImageHandle> textures {};
+        std::vector<SceneID> buttonLayers {};
+        std::vector<std::basic_string<char>> texts {};
+        // the rendered label, what it was rendered from & its size on screen
+        std::vector<ImageHandle> labels {};
+        std::vector<uint64_t> labelKeys {};
+        std::vector<SDL_Point> labelSizes {};
+        std::basic_string<char> labelFont {};
+        // output pixels per window pixel
+        float labelScale {1.0f};
+        // theme 0 is the default ColorData
+        std::vector<ColorData> themes {ColorData {}};
         SDL_Point mousePos {};
+        // indexed by scene ID
+        std::vector<Layer> layers {};
+        SceneID activeLayer {noScene};
+        SDL_Point hitArea {0, 0};
+        std::vector<ButtonID> hovered {};
+        std::vector<ButtonID> underCursor {};
+        std::vector<ButtonID> hitList {};
+        // hover fades, keyed by button ID
+        Tween tweens {};
     };
-} // namespace Application::Helper
\ No newline at end of file
+} // namespace Application::Helper
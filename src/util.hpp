@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SDL.h>
+#include <SDL_ttf.h>
 #include <memory>
 #include <iostream>
 
@@ -10,8 +11,9 @@ namespace Application::Helper::Utils {
         void operator()(SDL_Window *x) const { SDL_DestroyWindow(x); }
         void operator()(SDL_Renderer *x) const { SDL_DestroyRenderer(x); }
         void operator()(SDL_Texture *x) const { SDL_DestroyTexture(x); }
+        void operator()(TTF_Font *x) const { TTF_CloseFont(x); }
     };
-    /** Memory handler. Used to manage an SDL window, renderer, and/or textures without the overhead of a shared
+    /** Memory handler. Used to manage an SDL window, renderer, textures and/or fonts without the overhead of a shared
      * pointer.
      *
      * \param T -> SDL type to manage
@@ -49,4 +51,20 @@ namespace Application::Helper::Utils {
     template <class T> inline constexpr void panicln(T &&errMsg) noexcept {
         std::cout << std::forward<T>(errMsg) << ": " << SDL_GetError() << '\n';
     }
+    /** Hash a block of memory (64-bit FNV-1a). Not cryptographic, used for cache keys & checksums.
+     *
+     * \param data -> the memory to hash
+     * \param size -> the number of bytes to hash
+     * \param seed -> (optional) a previous hash to continue from
+     * \return the hash of the memory block.
+     */
+    inline uint64_t fnv1a(const void *data, size_t size, uint64_t seed = 0xcbf29ce484222325ull) noexcept {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            seed ^= bytes[i];
+            seed *= 0x100000001b3ull;
+        }
+
+        return seed;
+    }
 } // namespace Application::Helper::Utils
\ No newline at end of file
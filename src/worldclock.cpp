@@ -0,0 +1,250 @@
+#include "worldclock.hpp"
+#include "compositor.hpp"
+#include "memory.hpp"
+#include <algorithm>
+
+using namespace Application::Helper::Utils;
+
+namespace Application::Helper {
+    namespace {
+        constexpr char firstGlyph = ' ';
+        // space between the longest label & the times (px)
+        constexpr int labelGap = 4;
+
+        // the zone a name or a link (Asia/Calcutta -> Asia/Kolkata) points to, the tzdb is parsed on the first call
+        const std::chrono::time_zone *locate(std::string_view name) {
+            const std::chrono::tzdb &db = std::chrono::get_tzdb();
+            for (const std::chrono::time_zone_link &link : db.links) {
+                if (link.name() == name) {
+                    name = link.target();
+                    break;
+                }
+            }
+
+            // the zones are sorted by name
+            const auto iter = std::ranges::lower_bound(db.zones, name, {}, &std::chrono::time_zone::name);
+
+            return (iter != db.zones.end() && iter->name() == name) ? &*iter : nullptr;
+        }
+
+        // Europe/New_York -> New York
+        std::basic_string<char> cityName(std::string_view zoneName) {
+            std::basic_string<char> city(zoneName.substr(zoneName.find_last_of('/') + 1));
+            std::replace(city.begin(), city.end(), '_', ' ');
+
+            return city;
+        }
+    } // namespace
+
+    WorldClock::WorldClock(Image &image) : image(image) {}
+
+    int WorldClock::create(SDL_Renderer *ren, std::string_view fontFile, int fontSize) {
+        MemoryScope scope(MemTag::Text);
+        TTF_Font *font = image.getFont(fontFile, fontSize);
+        if (font == nullptr)
+            return -1;
+
+        // every glyph on one row, 1px apart so filtering never picks up a neighbour
+        std::array<SDL_Surface *, 95> surfaces {};
+        int width = 0;
+        int height = TTF_FontHeight(font);
+        for (size_t i = 0; i < glyphs.size(); ++i) {
+            const auto ch = static_cast<uint16_t>(firstGlyph + i);
+            int minX = 0, maxX = 0, minY = 0, maxY = 0, advance = 0;
+            TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &advance);
+            advances[i] = advance;
+            glyphs[i] = {0};
+
+            surfaces[i] = TTF_RenderGlyph_Blended(font, ch, {255, 255, 255, 255});
+            if (surfaces[i] == nullptr)
+                continue;
+
+            glyphs[i] = {width, 0, surfaces[i]->w, surfaces[i]->h};
+            width += surfaces[i]->w + 1;
+            height = std::max(height, surfaces[i]->h);
+        }
+
+        SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, std::max(width, 1), height, 32,
+                                                            SDL_PIXELFORMAT_ARGB8888);
+        for (size_t i = 0; i < surfaces.size(); ++i) {
+            if (surfaces[i] == nullptr)
+                continue;
+
+            if (sheet != nullptr) {
+                SDL_Rect dst = glyphs[i];
+                SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(surfaces[i], nullptr, sheet, &dst);
+            }
+            SDL_FreeSurface(surfaces[i]);
+        }
+
+        if (sheet == nullptr) {
+            panicln("Failed to create the glyph atlas");
+            return -1;
+        }
+        atlas = cheesecake(SDL_CreateTextureFromSurface(ren, sheet));
+        // a few kb, kept so the clocks can be drawn into a compositor
+        Compositor::toLayer(sheet, atlasLayer);
+        SDL_FreeSurface(sheet);
+        if (atlas == nullptr) {
+            panicln("Failed to create the glyph atlas");
+            return -1;
+        }
+        SDL_SetTextureBlendMode(atlas.get(), SDL_BLENDMODE_BLEND);
+
+        lineHeight = height;
+        // the labels have to be laid out again with the new glyphs
+        labelWidth = 0;
+        std::vector<Quad> quads;
+        for (Clock &clock : clocks) {
+            quads.clear();
+            layout(clock.label, 0, quads);
+            labelWidth = std::max(labelWidth, quads.empty() ? 0 : quads.back().dst.x + quads.back().dst.w);
+            clock.until = {};
+        }
+
+        return 0;
+    }
+
+    int WorldClock::addClock(std::string_view zoneName, std::string_view label) {
+        const size_t zone = findZone(zoneName);
+        if (zone == SIZE_MAX) {
+            println("Unknown time zone");
+            return -1;
+        }
+
+        MemoryScope scope(MemTag::Text);
+        Clock &clock = clocks.emplace_back();
+        clock.zone = zone;
+        clock.label = label.empty() ? cityName(zones[zone].name) : std::basic_string<char>(label);
+
+        // a longer label moves every time to the right
+        layout(clock.label, 0, clock.quads);
+        const int width = clock.quads.empty() ? 0 : clock.quads.back().dst.x + clock.quads.back().dst.w;
+        if (width > labelWidth) {
+            labelWidth = width;
+            for (Clock &other : clocks)
+                other.until = {};
+        }
+
+        return 0;
+    }
+
+    void WorldClock::clear() noexcept {
+        clocks.clear();
+        labelWidth = 0;
+        ++version;
+    }
+
+    bool WorldClock::update(std::chrono::system_clock::time_point now) {
+        const auto seconds = std::chrono::floor<std::chrono::seconds>(now);
+        bool changed = false;
+        for (Clock &clock : clocks) {
+            if (seconds >= clock.from && seconds < clock.until)
+                continue;
+
+            Zone &zone = zones[clock.zone];
+            if (seconds < zone.begin || seconds >= zone.end) {
+                const std::chrono::sys_info info = zone.zone->get_info(seconds);
+                zone.begin = info.begin;
+                zone.end = info.end;
+                zone.offset = info.offset;
+            }
+
+            // the local time as if it were utc, the text holds until the local minute or the offset changes
+            const std::chrono::sys_seconds local = seconds + zone.offset;
+            const auto minute = std::chrono::floor<std::chrono::minutes>(local);
+            clock.from = std::max<std::chrono::sys_seconds>(minute - zone.offset, zone.begin);
+            clock.until = std::min<std::chrono::sys_seconds>(minute + std::chrono::minutes(1) - zone.offset, zone.end);
+
+            // the same format as the main clock (%OI:%M & AM/PM)
+            const std::chrono::hh_mm_ss time(minute - std::chrono::floor<std::chrono::days>(minute));
+            const int hours = static_cast<int>(time.hours().count());
+            const int hour12 = (hours % 12 == 0) ? 12 : hours % 12;
+            const int minutes = static_cast<int>(time.minutes().count());
+            const char text[] {static_cast<char>('0' + hour12 / 10),
+                               static_cast<char>('0' + hour12 % 10),
+                               ':',
+                               static_cast<char>('0' + minutes / 10),
+                               static_cast<char>('0' + minutes % 10),
+                               (hours >= 12) ? 'P' : 'A',
+                               'M'};
+
+            clock.quads.clear();
+            layout(clock.label, 0, clock.quads);
+            layout({text, sizeof(text)}, labelWidth + labelGap, clock.quads);
+            changed = true;
+        }
+
+        if (changed)
+            ++version;
+
+        return changed;
+    }
+
+    void WorldClock::draw(SDL_Renderer *ren, int x, int y) {
+        if (atlas == nullptr || clocks.empty())
+            return;
+
+        for (const Clock &clock : clocks) {
+            for (const Quad &quad : clock.quads)
+                batch.drawTexture(atlas.get(), &quad.clip,
+                                  {x + quad.dst.x, y + quad.dst.y, quad.dst.w, quad.dst.h}, ren, &atlasLayer);
+            y += lineHeight;
+        }
+        batch.flush(ren);
+    }
+
+    int WorldClock::getTimeout(std::chrono::system_clock::time_point now) const noexcept {
+        if (clocks.empty())
+            return -1;
+
+        std::chrono::sys_seconds next = clocks.front().until;
+        for (const Clock &clock : clocks)
+            next = std::min(next, clock.until);
+
+        return static_cast<int>(std::max<int64_t>(
+                   std::chrono::ceil<std::chrono::milliseconds>(next - now).count(), 0)) + 1;
+    }
+
+    uint64_t WorldClock::getVersion() const noexcept {
+        return version;
+    }
+
+    size_t WorldClock::getClockCount() const noexcept {
+        return clocks.size();
+    }
+
+    Batch &WorldClock::getBatch() noexcept {
+        return batch;
+    }
+
+    size_t WorldClock::findZone(std::string_view zoneName) {
+        for (size_t i = 0; i < zones.size(); ++i) {
+            if (zones[i].name == zoneName)
+                return i;
+        }
+
+        const std::chrono::time_zone *zone = locate(zoneName);
+        if (zone == nullptr)
+            return SIZE_MAX;
+
+        // begin == end, the offset is read on the first update
+        zones.push_back({zone, std::basic_string<char>(zoneName)});
+
+        return zones.size() - 1;
+    }
+
+    void WorldClock::layout(std::string_view text, int x, std::vector<Quad> &quads) const {
+        for (const char ch : text) {
+            const auto index = static_cast<size_t>(static_cast<unsigned char>(ch) - firstGlyph);
+            if (index >= glyphs.size())
+                continue;
+
+            const SDL_Rect &glyph = glyphs[index];
+            if (glyph.w > 0)
+                quads.push_back({glyph, {x, 0, glyph.w, glyph.h}});
+            x += advances[index];
+        }
+    }
+} // namespace Application::Helper
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <SDL.h>
+#include "batch.hpp"
+#include "image.hpp"
+#include "util.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Structure
+ *
+ * WorldClock -> clocks of other time zones drawn as rows of "label time" in the main scene (--clock <zone>)
+ * Atlas -> every printable ASCII glyph of one font is rendered once into one texture, a clock is a few glyph quads
+ *          in a Batch, so all clocks are a single SDL_RenderGeometry call (the atlas is also kept as a layer for
+ *          a batch that draws into a compositor)
+ * Zones -> every time zone is looked up once in the tzdb & kept with its current offset (valid until the next
+ *          transition), clocks of the same zone share it
+ * Ticks -> a clock keeps the range of time its text is valid for & is only laid out again outside of it (its own
+ *          minute boundary or a transition of its zone)
+ */
+
+namespace Application::Helper {
+    class WorldClock final {
+    public:
+        /** WorldClock Constructor; the font comes from the image's font cache.
+         *
+         * \param image -> the images (fonts) to use
+         */
+        explicit WorldClock(Image &image);
+        /** Renders the glyph atlas.
+         *
+         * \param ren -> the renderer to use
+         * \param fontFile -> the font of the clocks
+         * \param fontSize -> the size of the font
+         * \return 0 if the operation succeeded, otherwise -1 if the font or the atlas failed to be created.
+         */
+        int create(SDL_Renderer *ren, std::string_view fontFile, int fontSize);
+        /** Adds a clock, shown below the others.
+         *
+         * \param zoneName -> the IANA name of the time zone (e.g. Europe/London)
+         * \param label -> (optional) the name shown next to the time, the city of the zone by default
+         * \return 0 if the operation succeeded, otherwise -1 if the time zone is unknown.
+         */
+        int addClock(std::string_view zoneName, std::string_view label = {});
+        /* Removes every clock (the zones & the atlas are kept).
+         */
+        void clear() noexcept;
+        /** Lays out the clocks that passed their minute boundary.
+         *
+         * \param now -> the current time
+         * \return true if any clock changed, otherwise false.
+         */
+        bool update(std::chrono::system_clock::time_point now);
+        /** Draws the clocks as rows, one call for all of them.
+         *
+         * \param ren -> the renderer to use
+         * \param x -> x position of the first row
+         * \param y -> y position of the first row
+         */
+        void draw(SDL_Renderer *ren, int x, int y);
+        /** Gets the time until the next clock changes.
+         *
+         * \param now -> the current time
+         * \return the time until the next update (ms), -1 if there are no clocks.
+         */
+        int getTimeout(std::chrono::system_clock::time_point now) const noexcept;
+        /** Gets a number that changes every time a clock does (for caching what they are drawn into).
+         *
+         * \return the number of changes so far.
+         */
+        uint64_t getVersion() const noexcept;
+        /** Gets the number of clocks.
+         *
+         * \return the clock count.
+         */
+        size_t getClockCount() const noexcept;
+        /** Gets the batch the glyph quads are drawn with.
+         *
+         * \return the batch.
+         */
+        Batch &getBatch() noexcept;
+
+    private:
+        struct Zone final {
+            const std::chrono::time_zone *zone {nullptr};
+            std::basic_string<char> name {};
+            // the offset holds within [begin, end)
+            std::chrono::sys_seconds begin {};
+            std::chrono::sys_seconds end {};
+            std::chrono::seconds offset {0};
+        };
+
+        struct Quad final {
+            SDL_Rect clip {0};
+            SDL_Rect dst {0};
+        };
+
+        struct Clock final {
+            size_t zone {0};
+            std::basic_string<char> label {};
+            // the text is valid within [from, until)
+            std::chrono::sys_seconds from {};
+            std::chrono::sys_seconds until {};
+            // glyph quads relative to the row, label & time
+            std::vector<Quad> quads {};
+        };
+
+        // finds or caches a zone, SIZE_MAX if it is unknown
+        size_t findZone(std::string_view zoneName);
+        // the glyph quads of a line of text from pen x
+        void layout(std::string_view text, int x, std::vector<Quad> &quads) const;
+
+    private:
+        Image &image;
+        Utils::SMD<SDL_Texture> atlas {nullptr};
+        Layer atlasLayer {};
+        // where every printable ASCII glyph is in the atlas & how far it moves the pen
+        std::array<SDL_Rect, 95> glyphs {};
+        std::array<int, 95> advances {};
+        int lineHeight {0};
+        int labelWidth {0};
+        std::vector<Zone> zones {};
+        std::vector<Clock> clocks {};
+        uint64_t version {0};
+        Batch batch {};
+    };
+} // namespace Application::Helper